@@ -0,0 +1,53 @@
+#!/usr/bin/env bash
+# Tequila Works test
+#
+# Runs a local dedicated server and a number of headless beam bots against it.
+# Server load lines (ServerLoad,players,avg tick ms,worst tick ms,beam ms,net flush ms,avg out B/s,worst out B/s,
+# avg in B/s,scalable objects,worst awake scalable objects) end up in the server log.
+#
+# Usage: RunBotLoadTest.sh [bots] [seconds] [map] [scenario]
+# scenario is a stress room file from the StressRoom commandlet, to compare runs with more idle cubes.
+# Needs the DiminuatorServer and Diminuator Linux builds, set PROJECT_BINARIES if they are not in Binaries/Linux.
+
+set -euo pipefail
+
+BOTS=${1:-32}
+DURATION=${2:-300}
+MAP=${3:-/Game/FirstPersonCPP/Maps/Playground}
+SCENARIO_ARG=()
+if [[ -n "${4:-}" ]]; then
+	SCENARIO_ARG=("-StressScenario=$4")
+fi
+
+PROJECT_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+BINARIES=${PROJECT_BINARIES:-"$PROJECT_DIR/Binaries/Linux"}
+LOG_DIR="$PROJECT_DIR/Saved/BotLoadTest/$(date +%Y%m%d-%H%M%S)"
+mkdir -p "$LOG_DIR"
+
+PIDS=()
+cleanup()
+{
+	kill "${PIDS[@]}" 2>/dev/null || true
+	wait 2>/dev/null || true
+}
+trap cleanup EXIT
+
+"$BINARIES/DiminuatorServer" "$MAP?MaxPlayers=$((BOTS + 1))" -log -unattended -LoadReport ${SCENARIO_ARG[@]+"${SCENARIO_ARG[@]}"} \
+	-abslog="$LOG_DIR/Server.log" > /dev/null 2>&1 &
+PIDS+=($!)
+
+# Give the server time to load the map before the bots join
+sleep 10
+
+for ((i = 0; i < BOTS; i++)); do
+	"$BINARIES/Diminuator" 127.0.0.1 -nullrhi -nosound -unattended -BeamBot -BeamBotSeed=$i \
+		-abslog="$LOG_DIR/Bot_$i.log" > /dev/null 2>&1 &
+	PIDS+=($!)
+	# Staggered joins, 32 logins on the same frame is not what we want to measure
+	sleep 0.5
+done
+
+echo "$BOTS bots running for $DURATION s, logs in $LOG_DIR"
+sleep "$DURATION"
+
+grep -h "ServerLoad," "$LOG_DIR/Server.log" || echo "No ServerLoad lines in $LOG_DIR/Server.log"
@@ -0,0 +1,18 @@
+// Tequila Works test
+
+using UnrealBuildTool;
+
+/*
+ * Engine independent beam decision logic. Only plain C++ in Public and Private,
+ * the same sources build outside the engine with Tools/BeamCore/CMakeLists.txt.
+ */
+public class BeamCore : ModuleRules
+{
+	public BeamCore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// Module boilerplate only, the beam code itself does not use the engine
+		PrivateDependencyModuleNames.AddRange(new string[] { "Core" });
+	}
+}
@@ -0,0 +1,213 @@
+// Tequila Works test
+#include "BeamClearance.h"
+
+#include <algorithm>
+
+namespace BeamCore
+{
+	namespace
+	{
+		struct FVertexProbe
+		{
+			FBeamVector Direction;
+			FBeamVector Vertex;
+		};
+
+		// Engine axes: forward X, right Y, up Z
+		const FBeamVector Up(0.0f, 0.0f, 1.0f);
+		const FBeamVector Down(0.0f, 0.0f, -1.0f);
+		const FBeamVector Left(0.0f, -1.0f, 0.0f);
+		const FBeamVector Right(0.0f, 1.0f, 0.0f);
+		const FBeamVector Forward(1.0f, 0.0f, 0.0f);
+		const FBeamVector Backward(-1.0f, 0.0f, 0.0f);
+
+		// Box: 4 vertex probes per face, faces in opposite pairs: up/down, left/right, forward/backward
+		const FVertexProbe BoxProbes[] =
+		{
+			{ Up, Up + Left + Forward },
+			{ Up, Up + Left + Backward },
+			{ Up, Up + Right + Forward },
+			{ Up, Up + Right + Backward },
+
+			{ Down, Down + Left + Forward },
+			{ Down, Down + Left + Backward },
+			{ Down, Down + Right + Forward },
+			{ Down, Down + Right + Backward },
+
+			{ Left, Left + Up + Forward },
+			{ Left, Left + Up + Backward },
+			{ Left, Left + Down + Forward },
+			{ Left, Left + Down + Backward },
+
+			{ Right, Right + Up + Forward },
+			{ Right, Right + Up + Backward },
+			{ Right, Right + Down + Forward },
+			{ Right, Right + Down + Backward },
+
+			{ Forward, Forward + Up + Left },
+			{ Forward, Forward + Up + Right },
+			{ Forward, Forward + Down + Left },
+			{ Forward, Forward + Down + Right },
+
+			{ Backward, Backward + Up + Left },
+			{ Backward, Backward + Up + Right },
+			{ Backward, Backward + Down + Left },
+			{ Backward, Backward + Down + Right },
+		};
+
+		// Sphere: 1 probe from each face center, same face order.
+		// Starts just under the bounding sphere surface when HalfLength is half the bounds radius
+		const float SphereReach = 1.8f;
+		const FVertexProbe SphereProbes[] =
+		{
+			{ Up, Up * SphereReach },
+			{ Down, Down * SphereReach },
+			{ Left, Left * SphereReach },
+			{ Right, Right * SphereReach },
+			{ Forward, Forward * SphereReach },
+			{ Backward, Backward * SphereReach },
+		};
+
+		static_assert(sizeof(BoxProbes) / sizeof(BoxProbes[0]) == BeamClearanceMaxProbes, "Box probes are the biggest set");
+
+		// Probe length along the face normal, in HalfLength units
+		const float RayLength = 0.25f;
+
+		const FVertexProbe* GetProbes(EBeamClearanceShape Shape)
+		{
+			return (Shape == EBeamClearanceShape::Sphere) ? SphereProbes : BoxProbes;
+		}
+
+		FBeamVector GetProbeEnd(const FVertexProbe& Probe)
+		{
+			return Probe.Vertex + Probe.Direction * RayLength;
+		}
+
+		/* Box around every probe of each face, in HalfLength units of the object axes */
+		struct FFaceRegions
+		{
+			FBeamVector Min[BeamClearanceFaces];
+			FBeamVector Max[BeamClearanceFaces];
+
+			explicit FFaceRegions(EBeamClearanceShape Shape)
+			{
+				const FVertexProbe* probes = GetProbes(Shape);
+				const int32_t probesPerFace = GetClearanceProbeCount(Shape) / BeamClearanceFaces;
+				for (int32_t face = 0; face < BeamClearanceFaces; ++face)
+				{
+					Min[face] = Max[face] = probes[face * probesPerFace].Vertex;
+					for (int32_t i = face * probesPerFace; i < (face + 1) * probesPerFace; ++i)
+					{
+						const FBeamVector points[] = { probes[i].Vertex, GetProbeEnd(probes[i]) };
+						for (const FBeamVector& point : points)
+						{
+							Min[face] = FBeamVector(std::min(Min[face].X, point.X), std::min(Min[face].Y, point.Y), std::min(Min[face].Z, point.Z));
+							Max[face] = FBeamVector(std::max(Max[face].X, point.X), std::max(Max[face].Y, point.Y), std::max(Max[face].Z, point.Z));
+						}
+					}
+				}
+			}
+		};
+
+		const FFaceRegions& GetFaceRegions(EBeamClearanceShape Shape)
+		{
+			static const FFaceRegions BoxRegions(EBeamClearanceShape::Box);
+			static const FFaceRegions SphereRegions(EBeamClearanceShape::Sphere);
+			return (Shape == EBeamClearanceShape::Sphere) ? SphereRegions : BoxRegions;
+		}
+	}
+
+	int32_t GetClearanceProbeCount(EBeamClearanceShape Shape)
+	{
+		return (Shape == EBeamClearanceShape::Sphere) ? static_cast<int32_t>(sizeof(SphereProbes) / sizeof(SphereProbes[0])) : BeamClearanceMaxProbes;
+	}
+
+	float GetClearanceReach(EBeamClearanceShape Shape)
+	{
+		const FVertexProbe* probes = GetProbes(Shape);
+		float reach = 0.0f;
+		for (int32_t i = 0; i < GetClearanceProbeCount(Shape); ++i)
+		{
+			const FBeamVector end = GetProbeEnd(probes[i]);
+			reach = std::max({ reach, std::fabs(end.X), std::fabs(end.Y), std::fabs(end.Z) });
+		}
+		return reach;
+	}
+
+	uint8_t GetOccupiedFaces(const FBeamClearanceTarget& Target, const FBeamVector& BodyCenter, const FBeamVector& BodyExtent)
+	{
+		// Body bounds in the object axes and HalfLength units
+		const float invHalfLength = 1.0f / Target.HalfLength;
+		const FBeamVector center = Target.Rotation.UnrotateVector(BodyCenter - Target.Center) * invHalfLength;
+		const FBeamVector axisX = Target.Rotation.RotateVector(FBeamVector(1.0f, 0.0f, 0.0f));
+		const FBeamVector axisY = Target.Rotation.RotateVector(FBeamVector(0.0f, 1.0f, 0.0f));
+		const FBeamVector axisZ = Target.Rotation.RotateVector(FBeamVector(0.0f, 0.0f, 1.0f));
+		auto projectExtent = [&BodyExtent](const FBeamVector& Axis)
+		{
+			return std::fabs(Axis.X) * BodyExtent.X + std::fabs(Axis.Y) * BodyExtent.Y + std::fabs(Axis.Z) * BodyExtent.Z;
+		};
+		const FBeamVector extent = FBeamVector(projectExtent(axisX), projectExtent(axisY), projectExtent(axisZ)) * invHalfLength;
+		const FBeamVector bodyMin = center - extent;
+		const FBeamVector bodyMax = center + extent;
+
+		const FFaceRegions& regions = GetFaceRegions(Target.Shape);
+		uint8_t faceMask = 0;
+		for (int32_t face = 0; face < BeamClearanceFaces; ++face)
+		{
+			const FBeamVector& regionMin = regions.Min[face];
+			const FBeamVector& regionMax = regions.Max[face];
+
+			// Touching counts, the probes of a resting object start on the surface below it
+			if (bodyMin.X <= regionMax.X && bodyMax.X >= regionMin.X
+				&& bodyMin.Y <= regionMax.Y && bodyMax.Y >= regionMin.Y
+				&& bodyMin.Z <= regionMax.Z && bodyMax.Z >= regionMin.Z)
+			{
+				faceMask |= 1 << face;
+			}
+		}
+		return faceMask;
+	}
+
+	bool IsBlockedByFacePairs(const bool FaceBlocked[BeamClearanceFaces])
+	{
+		return (FaceBlocked[0] && FaceBlocked[1]) || (FaceBlocked[2] && FaceBlocked[3]) || (FaceBlocked[4] && FaceBlocked[5]);
+	}
+
+	bool CheckClearance(IBeamProbeQueries& Queries, const FBeamClearanceTarget& Target, uint8_t FaceMask)
+	{
+		const FVertexProbe* probes = GetProbes(Target.Shape);
+		const int32_t numProbes = GetClearanceProbeCount(Target.Shape);
+		const int32_t probesPerFace = numProbes / BeamClearanceFaces;
+
+		// Read last results, stale or missing results are blocked to be safe
+		bool faceBlocked[BeamClearanceFaces] = {};
+		for (int32_t i = 0; i < numProbes; ++i)
+		{
+			if ((FaceMask & (1 << (i / probesPerFace))) == 0)
+			{
+				continue;
+			}
+
+			int32_t age = 0;
+			bool bHit = false;
+			const bool bHasResult = Queries.GetProbeResult(i, age, bHit);
+			faceBlocked[i / probesPerFace] |= !bHasResult || age > Target.MaxAge || bHit;
+		}
+
+		// Shoot the probes again with the current transform
+		const float rayLength = Target.HalfLength * RayLength;
+		for (int32_t i = 0; i < numProbes; ++i)
+		{
+			if ((FaceMask & (1 << (i / probesPerFace))) == 0)
+			{
+				continue;
+			}
+
+			const FBeamVector start = Target.Center + Target.Rotation.RotateVector(probes[i].Vertex * Target.HalfLength);
+			const FBeamVector end = start + Target.Rotation.RotateVector(probes[i].Direction) * rayLength;
+			Queries.SubmitProbe(i, start, end);
+		}
+
+		return IsBlockedByFacePairs(faceBlocked);
+	}
+}
@@ -0,0 +1,6 @@
+// Tequila Works test
+// Engine build only, the standalone build leaves this file out
+
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, BeamCore);
@@ -0,0 +1,145 @@
+// Tequila Works test
+#include "BeamRules.h"
+
+namespace BeamCore
+{
+	EBeamMode NextBeamMode(EBeamMode Current, EBeamMode Trigger)
+	{
+		if (Current == EBeamMode::Off)
+		{
+			return Trigger;
+		}
+
+		if (Current == EBeamMode::Grab)
+		{
+			if (Trigger == EBeamMode::Diminuator)
+			{
+				return EBeamMode::Augmentator;
+			}
+			if (Trigger == EBeamMode::Augmentator)
+			{
+				return EBeamMode::Diminuator;
+			}
+			return Current;
+		}
+
+		return (Current != Trigger) ? EBeamMode::Grab : EBeamMode::Off;
+	}
+
+	float GetBeamScaleRate(EBeamMode Mode, float ScaleSpeed)
+	{
+		switch (Mode)
+		{
+		case EBeamMode::Diminuator:
+			return -ScaleSpeed;
+
+		case EBeamMode::Augmentator:
+			return ScaleSpeed;
+
+		default:
+			return 0.0f;
+		}
+	}
+
+	bool ShouldCommitScale(const FBeamScaleCommitParams& Params, float TimeSinceCommit, float ExtentChange)
+	{
+		return TimeSinceCommit >= Params.Interval || std::fabs(ExtentChange) >= Params.Distance;
+	}
+
+	void FBeamRecentContacts::Add(const FBeamVector& Normal, float Time)
+	{
+		// About 8 degrees apart, the same surface hit again
+		const float sameSurfaceCos = 0.99f;
+		for (int32_t i = 0; i < Num; ++i)
+		{
+			if (FBeamVector::Dot(Normals[i], Normal) >= sameSurfaceCos)
+			{
+				Normals[i] = Normal;
+				Times[i] = Time;
+				return;
+			}
+		}
+
+		int32_t slot = Num;
+		if (Num < MaxContacts)
+		{
+			Num++;
+		}
+		else
+		{
+			slot = 0;
+			for (int32_t i = 1; i < Num; ++i)
+			{
+				if (Times[i] < Times[slot])
+				{
+					slot = i;
+				}
+			}
+		}
+		Normals[slot] = Normal;
+		Times[slot] = Time;
+	}
+
+	bool FBeamRecentContacts::GetMostOpposing(const FBeamVector& Direction, float Now, float Tolerance, FBeamVector& OutNormal) const
+	{
+		bool bFound = false;
+		float lowestDot = 0.0f;
+		for (int32_t i = 0; i < Num; ++i)
+		{
+			if (Now - Times[i] > Tolerance)
+			{
+				continue;
+			}
+
+			const float dot = FBeamVector::Dot(Normals[i], Direction);
+			if (!bFound || dot < lowestDot)
+			{
+				bFound = true;
+				lowestDot = dot;
+				OutNormal = Normals[i];
+			}
+		}
+		return bFound;
+	}
+
+	void FBeamRecentContacts::Reset()
+	{
+		Num = 0;
+	}
+
+	EBeamStuckAction FBeamStuckDetector::Update(const FBeamStuckParams& Params, float DeltaTime, const FBeamVector& TrackingError, const FBeamVector& ContactNormal, bool bRecentContact)
+	{
+		// Resting on the floor while pulled sideways is not blocking, pulled into a wall is
+		const float error = TrackingError.Size();
+		const bool bBlocked = bRecentContact
+			&& error > Params.MaxTrackingError
+			&& FBeamVector::Dot(ContactNormal, TrackingError * (1.0f / error)) <= -Params.MinBlockingAngleCos;
+
+		if (!bBlocked)
+		{
+			const EBeamStuckAction action = bStuck ? EBeamStuckAction::Unstuck : EBeamStuckAction::None;
+			Reset();
+			return action;
+		}
+
+		StuckTime += DeltaTime;
+		if (StuckTime >= Params.ReleaseTime)
+		{
+			Reset();
+			return EBeamStuckAction::Release;
+		}
+
+		if (!bStuck)
+		{
+			bStuck = true;
+			return EBeamStuckAction::Stuck;
+		}
+		return EBeamStuckAction::None;
+	}
+
+	void FBeamStuckDetector::Reset()
+	{
+		StuckTime = 0.0f;
+		bStuck = false;
+	}
+}
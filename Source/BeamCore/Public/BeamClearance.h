@@ -0,0 +1,78 @@
+// Tequila Works test
+#pragma once
+
+#include "BeamCoreTypes.h"
+
+namespace BeamCore
+{
+	/*
+	* Probes shot around a scaled object before letting it grow
+	*/
+	enum class EBeamClearanceShape : uint8_t
+	{
+		Box,		// 4 probes per face from the box corners
+		Sphere,		// 1 probe per face from the face centers
+	};
+
+	/* Faces in opposite pairs: up/down, left/right, forward/backward */
+	static const int32_t BeamClearanceFaces = 6;
+
+	/* Probes of the biggest shape, probe arrays sized for it fit every shape */
+	static const int32_t BeamClearanceMaxProbes = 24;
+
+	/* Face masks have bit N set for face N, in the face order above */
+	static const uint8_t BeamClearanceAllFaces = (1 << BeamClearanceFaces) - 1;
+
+	/*
+	* Scene side of the clearance probes, probes are indexed 0..GetClearanceProbeCount(Shape) - 1.
+	* Submitted probes can run later, results come back with their age in frames.
+	*/
+	class IBeamProbeQueries
+	{
+	public:
+
+		virtual ~IBeamProbeQueries() {}
+
+		/* Result of the last run of a probe, false if it never ran */
+		virtual bool GetProbeResult(int32_t Index, int32_t& OutAge, bool& bOutHit) const = 0;
+
+		/* Shoot a probe again along a segment in world space */
+		virtual void SubmitProbe(int32_t Index, const FBeamVector& Start, const FBeamVector& End) = 0;
+	};
+
+	/*
+	* Object the probes are shot around. Offsets are in HalfLength units: probes start at
+	* Center + Rotation * (Vertex * HalfLength) and go HalfLength / 4 along the face normal.
+	*/
+	struct FBeamClearanceTarget
+	{
+		FBeamVector Center;
+		FBeamQuat Rotation;
+		float HalfLength;
+		EBeamClearanceShape Shape;
+
+		// Frames a result is trusted, older or missing results count as blocked
+		int32_t MaxAge;
+	};
+
+	BEAMCORE_API int32_t GetClearanceProbeCount(EBeamClearanceShape Shape);
+
+	/* Farthest a probe gets from the center along any axis of the object, in HalfLength units */
+	BEAMCORE_API float GetClearanceReach(EBeamClearanceShape Shape);
+
+	/*
+	* Faces whose probes could hit a body with the given world space bounding box.
+	* Conservative: the box is bounded again in the object axes before testing the probes.
+	*/
+	BEAMCORE_API uint8_t GetOccupiedFaces(const FBeamClearanceTarget& Target, const FBeamVector& BodyCenter, const FBeamVector& BodyExtent);
+
+	/* Blocked when both faces of any opposite pair are blocked, the object would get squeezed */
+	BEAMCORE_API bool IsBlockedByFacePairs(const bool FaceBlocked[BeamClearanceFaces]);
+
+	/*
+	* Reads the last probe results, shoots the probes again for the current transform and
+	* returns whether growing is blocked. Results of this call's probes are read next time.
+	* Faces out of FaceMask are clear, their probes are neither read nor shot.
+	*/
+	BEAMCORE_API bool CheckClearance(IBeamProbeQueries& Queries, const FBeamClearanceTarget& Target, uint8_t FaceMask = BeamClearanceAllFaces);
+}
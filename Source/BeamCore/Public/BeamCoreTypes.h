@@ -0,0 +1,77 @@
+// Tequila Works test
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+// Set by the engine build, the standalone build has no export macro
+#ifndef BEAMCORE_API
+#define BEAMCORE_API
+#endif
+
+namespace BeamCore
+{
+	/*
+	* Beam state, same values as the game BeamMode enum
+	*/
+	enum class EBeamMode : uint8_t
+	{
+		Diminuator,
+		Augmentator,
+		Grab,
+		Off,
+	};
+
+	struct FBeamVector
+	{
+		float X;
+		float Y;
+		float Z;
+
+		FBeamVector() : X(0.0f), Y(0.0f), Z(0.0f) {}
+		FBeamVector(float InX, float InY, float InZ) : X(InX), Y(InY), Z(InZ) {}
+
+		FBeamVector operator+(const FBeamVector& Other) const { return FBeamVector(X + Other.X, Y + Other.Y, Z + Other.Z); }
+		FBeamVector operator-(const FBeamVector& Other) const { return FBeamVector(X - Other.X, Y - Other.Y, Z - Other.Z); }
+		FBeamVector operator*(float Scale) const { return FBeamVector(X * Scale, Y * Scale, Z * Scale); }
+
+		float Size() const { return std::sqrt(X * X + Y * Y + Z * Z); }
+
+		static float Dot(const FBeamVector& A, const FBeamVector& B)
+		{
+			return A.X * B.X + A.Y * B.Y + A.Z * B.Z;
+		}
+
+		static FBeamVector Cross(const FBeamVector& A, const FBeamVector& B)
+		{
+			return FBeamVector(A.Y * B.Z - A.Z * B.Y, A.Z * B.X - A.X * B.Z, A.X * B.Y - A.Y * B.X);
+		}
+	};
+
+	/*
+	* Unit rotation quaternion, same layout and convention as FQuat
+	*/
+	struct FBeamQuat
+	{
+		float X;
+		float Y;
+		float Z;
+		float W;
+
+		FBeamQuat() : X(0.0f), Y(0.0f), Z(0.0f), W(1.0f) {}
+		FBeamQuat(float InX, float InY, float InZ, float InW) : X(InX), Y(InY), Z(InZ), W(InW) {}
+
+		FBeamVector RotateVector(const FBeamVector& V) const
+		{
+			// v' = v + w * t + q x t, with t = 2 * (q x v)
+			const FBeamVector q(X, Y, Z);
+			const FBeamVector t = FBeamVector::Cross(q, V) * 2.0f;
+			return V + t * W + FBeamVector::Cross(q, t);
+		}
+
+		FBeamVector UnrotateVector(const FBeamVector& V) const
+		{
+			return FBeamQuat(-X, -Y, -Z, W).RotateVector(V);
+		}
+	};
+}
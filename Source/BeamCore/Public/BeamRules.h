@@ -0,0 +1,123 @@
+// Tequila Works test
+#pragma once
+
+#include "BeamCoreTypes.h"
+
+namespace BeamCore
+{
+	/*
+	* Trigger state machine. From OFF a trigger selects its mode, the other trigger on top
+	* of it grabs, and releasing one trigger while grabbing leaves the other mode on.
+	* Trigger is the mode of the trigger pressed or released.
+	*/
+	BEAMCORE_API EBeamMode NextBeamMode(EBeamMode Current, EBeamMode Trigger);
+
+	/* Scale change per second of a mode, diminuator shrinks and augmentator grows */
+	BEAMCORE_API float GetBeamScaleRate(EBeamMode Mode, float ScaleSpeed);
+
+	/*
+	* Scale limits of the beamed object, in whatever size metric the caller uses
+	*/
+	struct FBeamScaleLimits
+	{
+		float Min;
+		float Max;
+
+		// Shrinking down to exactly Min is allowed
+		bool bMinInclusive;
+	};
+
+	/*
+	* Important!
+	* Only scale if scaling up within Max and collisions are clear, or if scaling down and Min is not reached.
+	* IsBlocked is only called when scaling up, it can be expensive.
+	*/
+	template<typename ClearanceCheckType>
+	bool CanScale(const FBeamScaleLimits& Limits, float CurrentSize, float NewSize, ClearanceCheckType&& IsBlocked)
+	{
+		if (NewSize > CurrentSize)
+		{
+			return NewSize <= Limits.Max && !IsBlocked();
+		}
+		if (NewSize < CurrentSize)
+		{
+			return Limits.bMinInclusive ? NewSize >= Limits.Min : NewSize > Limits.Min;
+		}
+		return false;
+	}
+
+	struct FBeamScaleCommitParams
+	{
+		// Seconds between collision rebuilds while scaling
+		float Interval;
+
+		// Growth or shrink of the half extent, in world units, that rebuilds right away
+		float Distance;
+	};
+
+	/*
+	* Scale preview commit rule: the physics body gets the previewed scale every Interval,
+	* or sooner once the collision is Distance away from what the player sees.
+	* In world units so small objects do not rebuild every frame.
+	*/
+	BEAMCORE_API bool ShouldCommitScale(const FBeamScaleCommitParams& Params, float TimeSinceCommit, float ExtentChange);
+
+	struct FBeamStuckParams
+	{
+		// Distance between the handle target and the body that counts as not following
+		float MaxTrackingError;
+
+		// Seconds stuck before the object is released
+		float ReleaseTime;
+
+		// A contact blocks when its normal points against the way to the target at least this much (0..1)
+		float MinBlockingAngleCos;
+	};
+
+	enum class EBeamStuckAction : uint8_t
+	{
+		None,
+		Stuck,		// Started not following because of a blocking contact
+		Unstuck,	// Following again before the release
+		Release,
+	};
+
+	/*
+	* Recent contacts of the grabbed object. A body dragged along the floor into a wall gets
+	* both hits on the same physics step, so one last normal depends on the callback order.
+	* Similar normals share a slot, the oldest one is replaced when full.
+	*/
+	struct BEAMCORE_API FBeamRecentContacts
+	{
+		static const int32_t MaxContacts = 4;
+
+		FBeamVector Normals[MaxContacts];
+		float Times[MaxContacts] = {};
+		int32_t Num = 0;
+
+		void Add(const FBeamVector& Normal, float Time);
+
+		/* Normal pointing the most against Direction among the contacts at most Tolerance old, false when there are none */
+		bool GetMostOpposing(const FBeamVector& Direction, float Now, float Tolerance, FBeamVector& OutNormal) const;
+
+		void Reset();
+	};
+
+	/*
+	* Grabbed object stuck detection. The object is stuck while it does not follow the handle
+	* target and a contact blocks the way, fast swings without contacts never release it.
+	*/
+	struct BEAMCORE_API FBeamStuckDetector
+	{
+		float StuckTime = 0.0f;
+		bool bStuck = false;
+
+		/*
+		* TrackingError goes from the body to the handle target. ContactNormal is the normal of the
+		* last contact, pointing out of the obstacle, only used when bRecentContact is set.
+		*/
+		EBeamStuckAction Update(const FBeamStuckParams& Params, float DeltaTime, const FBeamVector& TrackingError, const FBeamVector& ContactNormal, bool bRecentContact);
+
+		void Reset();
+	};
+}
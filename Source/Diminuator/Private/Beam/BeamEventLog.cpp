@@ -0,0 +1,293 @@
+// Tequila Works test
+#include "Beam/BeamEventLog.h"
+
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Paths.h"
+#include "Serialization/Archive.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogBeamEvents, Log, All);
+
+static TAutoConsoleVariable<int32> CVarBeamEventLogMaxFileMB(
+	TEXT("beam.EventLog.MaxFileMB"),
+	16,
+	TEXT("Beam event log files rotate after this size, in megabytes."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarBeamEventLogMaxFiles(
+	TEXT("beam.EventLog.MaxFiles"),
+	8,
+	TEXT("Beam event log files kept, older ones are deleted."),
+	ECVF_Default);
+
+namespace BeamEventLog
+{
+	namespace
+	{
+		const TCHAR* Directory = TEXT("BeamEvents");
+		const TCHAR* Extension = TEXT(".bevt");
+
+		// Writer sleep when the ring is empty, in seconds
+		const float IdleSleep = 0.005f;
+	}
+}
+
+std::atomic<FBeamEventLog*> FBeamEventLog::Instance(nullptr);
+std::atomic<int32> FBeamEventLog::ActiveRecorders(0);
+
+void FBeamEventLog::Startup()
+{
+	if (Instance.load(std::memory_order_acquire) != nullptr || IsRunningCommandlet() || FParse::Param(FCommandLine::Get(), TEXT("NoBeamEventLog")))
+	{
+		return;
+	}
+
+	FBeamEventLog* log = new FBeamEventLog();
+	if (!log->OpenFile())
+	{
+		delete log;
+		return;
+	}
+
+	log->Thread = FRunnableThread::Create(log, TEXT("BeamEventLog"), 0, TPri_BelowNormal);
+	if (log->Thread == nullptr)
+	{
+		delete log;
+		return;
+	}
+
+	Instance.store(log, std::memory_order_release);
+}
+
+void FBeamEventLog::Shutdown()
+{
+	FBeamEventLog* log = Instance.load(std::memory_order_acquire);
+	if (log != nullptr)
+	{
+		// Writer first, it flushes what is left and exits. Records pushed after that stay in the ring
+		log->Thread->Kill(true);
+
+		// Then no new records, and the log outlives the ones already inside Record
+		Instance.store(nullptr);
+		while (ActiveRecorders.load() != 0)
+		{
+			FPlatformProcess::Yield();
+		}
+		delete log;
+	}
+}
+
+FBeamEventLog::FBeamEventLog()
+	: DroppedRecords(0)
+	, StartSeconds(FPlatformTime::Seconds())
+	, StartUtc(FDateTime::UtcNow())
+	, Thread(nullptr)
+	, bStopping(false)
+	, FileIndex(0)
+	, ReportedDropped(0)
+{
+	Batch.Reserve(1024);
+	BaseFileName = FPaths::Combine(FPaths::ProjectSavedDir(), BeamEventLog::Directory, FString::Printf(TEXT("BeamEvents_%s"), *StartUtc.ToString()));
+}
+
+FBeamEventLog::~FBeamEventLog()
+{
+	delete Thread;
+	CloseFile();
+}
+
+void FBeamEventLog::Push(EBeamEventType Type, const UObject* Source, const AActor* Target, const FVector& Location, float Value, uint8 State, uint8 Arg)
+{
+	FBeamEventRecord record;
+	record.Time = FPlatformTime::Seconds() - StartSeconds;
+	record.Frame = static_cast<uint32>(GFrameCounter);
+	record.ThreadId = FPlatformTLS::GetCurrentThreadId();
+	record.Type = static_cast<uint8>(Type);
+	record.State = State;
+	record.Arg = Arg;
+	record.Pad = 0;
+	record.SourceId = (Source != nullptr) ? Source->GetUniqueID() : 0;
+	if (Target != nullptr)
+	{
+		// Name index only, the writer thread resolves the string once per file
+		const FName targetName = Target->GetFName();
+		record.TargetNameId = targetName.GetDisplayIndex().ToUnstableInt();
+		record.TargetNameNumber = targetName.GetNumber();
+	}
+	else
+	{
+		record.TargetNameId = 0;
+		record.TargetNameNumber = 0;
+	}
+	record.Location[0] = Location.X;
+	record.Location[1] = Location.Y;
+	record.Location[2] = Location.Z;
+	record.Value = Value;
+
+	if (!Ring.TryPush(record))
+	{
+		DroppedRecords.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+uint32 FBeamEventLog::Run()
+{
+	while (!bStopping.load(std::memory_order_relaxed))
+	{
+		if (Drain() == 0)
+		{
+			FPlatformProcess::Sleep(BeamEventLog::IdleSleep);
+		}
+	}
+
+	// Whatever was recorded before shutdown
+	Drain();
+	return 0;
+}
+
+void FBeamEventLog::Stop()
+{
+	bStopping.store(true, std::memory_order_relaxed);
+}
+
+int32 FBeamEventLog::Drain()
+{
+	int32 numWritten = 0;
+	FBeamEventRecord record;
+	while (Ring.TryPop(record))
+	{
+		Batch.Add(record);
+		if (Batch.Num() == Batch.Max())
+		{
+			numWritten += Batch.Num();
+			WriteBatch();
+		}
+	}
+
+	// Losses show up in the log itself
+	const uint64 dropped = DroppedRecords.load(std::memory_order_relaxed);
+	if (dropped != ReportedDropped)
+	{
+		FBeamEventRecord& droppedRecord = Batch.AddZeroed_GetRef();
+		droppedRecord.Time = FPlatformTime::Seconds() - StartSeconds;
+		droppedRecord.Frame = static_cast<uint32>(GFrameCounter);
+		droppedRecord.ThreadId = FPlatformTLS::GetCurrentThreadId();
+		droppedRecord.Type = static_cast<uint8>(EBeamEventType::Dropped);
+		droppedRecord.Value = static_cast<float>(dropped - ReportedDropped);
+		ReportedDropped = dropped;
+	}
+
+	if (Batch.Num() > 0)
+	{
+		numWritten += Batch.Num();
+		WriteBatch();
+	}
+
+	// Flushed every drain so a crash loses as little as possible
+	if (numWritten > 0 && File)
+	{
+		File->Flush();
+	}
+	return numWritten;
+}
+
+void FBeamEventLog::WriteBatch()
+{
+	if (!File)
+	{
+		Batch.Reset();
+		return;
+	}
+
+	// Names first time they show up in this file
+	NameBlock.Reset();
+	uint32 numNames = 0;
+	for (const FBeamEventRecord& record : Batch)
+	{
+		if (record.TargetNameId == 0 || WrittenNames.Contains(record.TargetNameId))
+		{
+			continue;
+		}
+		WrittenNames.Add(record.TargetNameId);
+
+		const FString name = FName::CreateFromDisplayId(FNameEntryId::FromUnstableInt(record.TargetNameId), 0).ToString();
+		const FTCHARToUTF8 utf8(*name);
+		const uint16 length = static_cast<uint16>(FMath::Min(utf8.Length(), static_cast<int32>(MAX_uint16)));
+		NameBlock.Append(reinterpret_cast<const uint8*>(&record.TargetNameId), sizeof(uint32));
+		NameBlock.Append(reinterpret_cast<const uint8*>(&length), sizeof(uint16));
+		NameBlock.Append(reinterpret_cast<const uint8*>(utf8.Get()), length);
+		numNames++;
+	}
+
+	if (numNames > 0)
+	{
+		FBeamEventBlockHeader namesHeader = { static_cast<uint32>(EBeamEventBlock::Names), numNames };
+		File->Serialize(&namesHeader, sizeof(namesHeader));
+		File->Serialize(NameBlock.GetData(), NameBlock.Num());
+	}
+
+	FBeamEventBlockHeader eventsHeader = { static_cast<uint32>(EBeamEventBlock::Events), static_cast<uint32>(Batch.Num()) };
+	File->Serialize(&eventsHeader, sizeof(eventsHeader));
+	File->Serialize(Batch.GetData(), Batch.Num() * sizeof(FBeamEventRecord));
+	Batch.Reset();
+
+	// Rotate, the next file starts with its own names
+	const int64 maxFileBytes = static_cast<int64>(FMath::Max(CVarBeamEventLogMaxFileMB.GetValueOnAnyThread(), 1)) * 1024 * 1024;
+	if (File->Tell() >= maxFileBytes)
+	{
+		CloseFile();
+		FileIndex++;
+		OpenFile();
+	}
+}
+
+bool FBeamEventLog::OpenFile()
+{
+	const FString fileName = FString::Printf(TEXT("%s_%03u%s"), *BaseFileName, FileIndex, BeamEventLog::Extension);
+	File.Reset(IFileManager::Get().CreateFileWriter(*fileName, FILEWRITE_AllowRead));
+	if (!File)
+	{
+		UE_LOG(LogBeamEvents, Warning, TEXT("Could not open beam event log %s"), *fileName);
+		return false;
+	}
+
+	FBeamEventFileHeader header;
+	FMemory::Memzero(header);
+	header.Magic = BEAM_EVENT_MAGIC;
+	header.Version = BEAM_EVENT_VERSION;
+	header.RecordSize = sizeof(FBeamEventRecord);
+	header.FileIndex = FileIndex;
+	header.StartUtcTicks = StartUtc.GetTicks();
+	File->Serialize(&header, sizeof(header));
+
+	WrittenNames.Reset();
+	DeleteOldFiles();
+	return true;
+}
+
+void FBeamEventLog::CloseFile()
+{
+	if (File)
+	{
+		File->Close();
+		File.Reset();
+	}
+}
+
+void FBeamEventLog::DeleteOldFiles()
+{
+	const FString directory = FPaths::Combine(FPaths::ProjectSavedDir(), BeamEventLog::Directory);
+	TArray<FString> fileNames;
+	IFileManager::Get().FindFiles(fileNames, *directory, BeamEventLog::Extension);
+
+	// Names carry the start time and index, alphabetical order is age order
+	fileNames.Sort();
+	const int32 numToDelete = fileNames.Num() - FMath::Max(CVarBeamEventLogMaxFiles.GetValueOnAnyThread(), 1);
+	for (int32 i = 0; i < numToDelete; ++i)
+	{
+		IFileManager::Get().Delete(*FPaths::Combine(directory, fileNames[i]));
+	}
+}
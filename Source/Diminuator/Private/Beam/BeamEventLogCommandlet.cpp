@@ -0,0 +1,208 @@
+// Tequila Works test
+#include "Beam/BeamEventLogCommandlet.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogBeamEventConvert, Log, All);
+
+namespace BeamEventConvert
+{
+namespace
+{
+	const TCHAR* TypeNames[] = { TEXT("StateChange"), TEXT("Grab"), TEXT("Release"), TEXT("StuckTimerStart"), TEXT("StuckTimerFire"), TEXT("ScaleBlocked"), TEXT("ProjectileImpact"), TEXT("Dropped") };
+	static_assert(UE_ARRAY_COUNT(TypeNames) == static_cast<int32>(EBeamEventType::Count), "Missing beam event type names");
+
+	// Same order as BeamMode
+	const TCHAR* StateNames[] = { TEXT("DIMINUATOR"), TEXT("AUGMENTATOR"), TEXT("GRAB"), TEXT("OFF") };
+
+	const TCHAR* CsvHeader = TEXT("Time,UtcTime,Frame,Thread,Type,State,PreviousState,Source,Target,X,Y,Z,Value");
+
+	const TCHAR* GetName(const TCHAR* const* Names, int32 NumNames, uint8 Value)
+	{
+		return (Value < NumNames) ? Names[Value] : TEXT("Unknown");
+	}
+
+	// JSON has no inf or nan, those are written as null. Locations are rounded to hundredths
+	FString JsonNumber(float Value, bool bLocation)
+	{
+		if (!FMath::IsFinite(Value))
+		{
+			return TEXT("null");
+		}
+		return bLocation ? FString::Printf(TEXT("%.2f"), Value) : FString::Printf(TEXT("%g"), Value);
+	}
+}
+}
+
+UBeamEventLogCommandlet::UBeamEventLogCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UBeamEventLogCommandlet::Main(const FString& Params)
+{
+	FString inPath;
+	if (!FParse::Value(*Params, TEXT("In="), inPath))
+	{
+		UE_LOG(LogBeamEventConvert, Error, TEXT("Missing -In=<file or directory>"));
+		return 1;
+	}
+	if (FPaths::IsRelative(inPath))
+	{
+		inPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("BeamEvents"), inPath);
+	}
+
+	FString format = TEXT("csv");
+	FParse::Value(*Params, TEXT("Format="), format);
+	const bool bJson = format.Equals(TEXT("json"), ESearchCase::IgnoreCase);
+
+	// A directory converts every log in it, names sort by start time and file index
+	TArray<FString> inFiles;
+	if (IFileManager::Get().DirectoryExists(*inPath))
+	{
+		IFileManager::Get().FindFiles(inFiles, *inPath, TEXT(".bevt"));
+		inFiles.Sort();
+		for (FString& fileName : inFiles)
+		{
+			fileName = FPaths::Combine(inPath, fileName);
+		}
+	}
+	else
+	{
+		inFiles.Add(inPath);
+	}
+
+	FString outFile;
+	if (!FParse::Value(*Params, TEXT("Out="), outFile))
+	{
+		outFile = FPaths::ChangeExtension(inPath, bJson ? TEXT("json") : TEXT("csv"));
+	}
+
+	TArray<FString> lines;
+	for (const FString& fileName : inFiles)
+	{
+		if (!ConvertFile(fileName, bJson, lines))
+		{
+			UE_LOG(LogBeamEventConvert, Warning, TEXT("Skipping %s, not a beam event log"), *fileName);
+		}
+	}
+
+	FString out;
+	if (bJson)
+	{
+		out = TEXT("[\n") + FString::Join(lines, TEXT(",\n")) + TEXT("\n]\n");
+	}
+	else
+	{
+		out = FString(BeamEventConvert::CsvHeader) + TEXT("\n") + FString::Join(lines, TEXT("\n")) + TEXT("\n");
+	}
+
+	if (!FFileHelper::SaveStringToFile(out, *outFile, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogBeamEventConvert, Error, TEXT("Could not write %s"), *outFile);
+		return 1;
+	}
+
+	UE_LOG(LogBeamEventConvert, Display, TEXT("Converted %d events from %d files to %s"), lines.Num(), inFiles.Num(), *outFile);
+	return 0;
+}
+
+bool UBeamEventLogCommandlet::ConvertFile(const FString& FileName, bool bJson, TArray<FString>& OutLines) const
+{
+	TArray<uint8> data;
+	if (!FFileHelper::LoadFileToArray(data, *FileName) || data.Num() < static_cast<int32>(sizeof(FBeamEventFileHeader)))
+	{
+		return false;
+	}
+
+	FBeamEventFileHeader header;
+	FMemory::Memcpy(&header, data.GetData(), sizeof(header));
+	if (header.Magic != BEAM_EVENT_MAGIC || header.Version != BEAM_EVENT_VERSION || header.RecordSize != sizeof(FBeamEventRecord))
+	{
+		return false;
+	}
+	const FDateTime startUtc(header.StartUtcTicks);
+
+	// Blocks until the end, a crash can leave the last one cut short
+	TMap<uint32, FString> names;
+	int64 offset = sizeof(FBeamEventFileHeader);
+	while (offset + static_cast<int64>(sizeof(FBeamEventBlockHeader)) <= data.Num())
+	{
+		FBeamEventBlockHeader block;
+		FMemory::Memcpy(&block, data.GetData() + offset, sizeof(block));
+		offset += sizeof(block);
+
+		if (block.Type == static_cast<uint32>(EBeamEventBlock::Names))
+		{
+			for (uint32 i = 0; i < block.Count; ++i)
+			{
+				uint32 nameId;
+				uint16 length;
+				if (offset + static_cast<int64>(sizeof(nameId) + sizeof(length)) > data.Num())
+				{
+					return true;
+				}
+				FMemory::Memcpy(&nameId, data.GetData() + offset, sizeof(nameId));
+				FMemory::Memcpy(&length, data.GetData() + offset + sizeof(nameId), sizeof(length));
+				offset += sizeof(nameId) + sizeof(length);
+				if (offset + length > data.Num())
+				{
+					return true;
+				}
+				const FUTF8ToTCHAR name(reinterpret_cast<const ANSICHAR*>(data.GetData() + offset), length);
+				names.Add(nameId, FString(name.Length(), name.Get()));
+				offset += length;
+			}
+		}
+		else if (block.Type == static_cast<uint32>(EBeamEventBlock::Events))
+		{
+			for (uint32 i = 0; i < block.Count && offset + static_cast<int64>(sizeof(FBeamEventRecord)) <= data.Num(); ++i)
+			{
+				FBeamEventRecord record;
+				FMemory::Memcpy(&record, data.GetData() + offset, sizeof(record));
+				offset += sizeof(record);
+				OutLines.Add(FormatEvent(record, startUtc, names, bJson));
+			}
+		}
+		else
+		{
+			UE_LOG(LogBeamEventConvert, Warning, TEXT("Unknown block %u in %s"), block.Type, *FileName);
+			return true;
+		}
+	}
+	return true;
+}
+
+FString UBeamEventLogCommandlet::FormatEvent(const FBeamEventRecord& Record, const FDateTime& StartUtc, const TMap<uint32, FString>& Names, bool bJson)
+{
+	using namespace BeamEventConvert;
+
+	// Same text FName gives, number 0 means no suffix
+	FString target;
+	if (const FString* name = Names.Find(Record.TargetNameId))
+	{
+		target = (Record.TargetNameNumber != NAME_NO_NUMBER_INTERNAL) ? FString::Printf(TEXT("%s_%d"), **name, NAME_INTERNAL_TO_EXTERNAL(Record.TargetNameNumber)) : *name;
+	}
+
+	const FString utcTime = (StartUtc + FTimespan::FromSeconds(Record.Time)).ToIso8601();
+	const TCHAR* type = GetName(TypeNames, UE_ARRAY_COUNT(TypeNames), Record.Type);
+	const bool bHasState = Record.Type != static_cast<uint8>(EBeamEventType::Dropped) && Record.Type != static_cast<uint8>(EBeamEventType::ProjectileImpact);
+	const TCHAR* state = bHasState ? GetName(StateNames, UE_ARRAY_COUNT(StateNames), Record.State) : TEXT("");
+	const TCHAR* previousState = (Record.Type == static_cast<uint8>(EBeamEventType::StateChange)) ? GetName(StateNames, UE_ARRAY_COUNT(StateNames), Record.Arg) : TEXT("");
+
+	if (bJson)
+	{
+		return FString::Printf(TEXT("{\"time\":%.6f,\"utc\":\"%s\",\"frame\":%u,\"thread\":%u,\"type\":\"%s\",\"state\":\"%s\",\"previousState\":\"%s\",\"source\":%u,\"target\":\"%s\",\"location\":[%s,%s,%s],\"value\":%s}"),
+			Record.Time, *utcTime, Record.Frame, Record.ThreadId, type, state, previousState, Record.SourceId, *target.ReplaceCharWithEscapedChar(),
+			*JsonNumber(Record.Location[0], true), *JsonNumber(Record.Location[1], true), *JsonNumber(Record.Location[2], true), *JsonNumber(Record.Value, false));
+	}
+
+	return FString::Printf(TEXT("%.6f,%s,%u,%u,%s,%s,%s,%u,%s,%.2f,%.2f,%.2f,%g"),
+		Record.Time, *utcTime, Record.Frame, Record.ThreadId, type, state, previousState, Record.SourceId, *target,
+		Record.Location[0], Record.Location[1], Record.Location[2], Record.Value);
+}
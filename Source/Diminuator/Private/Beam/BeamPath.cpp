@@ -0,0 +1,388 @@
+// Tequila Works test
+#include "Beam/BeamPath.h"
+
+#include "Diminuator.h"
+#include "DiminuatorTypes.h"
+#include "Beam/BeamQuerySubsystem.h"
+#include "Engine/World.h"
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Actor.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Queries"), STAT_BeamPathQueries, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Queries Segment 0"), STAT_BeamPathQueriesSegment0, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Queries Segment 1"), STAT_BeamPathQueriesSegment1, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Queries Segment 2"), STAT_BeamPathQueriesSegment2, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Queries Segment 3"), STAT_BeamPathQueriesSegment3, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Cache Hits"), STAT_BeamPathCacheHits, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Budget Exhausted"), STAT_BeamPathBudgetExhausted, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Cache Intrusions"), STAT_BeamPathCacheIntrusions, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Watched Bodies"), STAT_BeamPathWatchedBodies, STATGROUP_Beam);
+DECLARE_CYCLE_STAT(TEXT("Path Trace"), STAT_BeamPathTrace, STATGROUP_Beam);
+DECLARE_CYCLE_STAT(TEXT("Path Cache Check"), STAT_BeamPathCacheCheck, STATGROUP_Beam);
+
+namespace BeamPath
+{
+	namespace
+	{
+		// Static geometry cannot move in, only movable object types are watched
+		FCollisionObjectQueryParams MakeWatchedObjects()
+		{
+			FCollisionObjectQueryParams objectParams;
+			objectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+			objectParams.AddObjectTypesToQuery(ECC_PhysicsBody);
+			objectParams.AddObjectTypesToQuery(ECC_Pawn);
+			objectParams.AddObjectTypesToQuery(ECC_Scalable);
+			objectParams.AddObjectTypesToQuery(ECC_Glass);
+			return objectParams;
+		}
+
+		bool ContainsComponent(TArrayView<const TPair<TWeakObjectPtr<UPrimitiveComponent>, FTransform>> Entries, const UPrimitiveComponent* Component)
+		{
+			return Entries.ContainsByPredicate([Component](const TPair<TWeakObjectPtr<UPrimitiveComponent>, FTransform>& entry)
+			{
+				return entry.Key.Get() == Component;
+			});
+		}
+	}
+}
+
+static void IncSegmentQueryStat(int32 Segment)
+{
+	switch (Segment)
+	{
+	case 0:
+		INC_DWORD_STAT(STAT_BeamPathQueriesSegment0);
+		break;
+
+	case 1:
+		INC_DWORD_STAT(STAT_BeamPathQueriesSegment1);
+		break;
+
+	case 2:
+		INC_DWORD_STAT(STAT_BeamPathQueriesSegment2);
+		break;
+
+	case 3:
+		INC_DWORD_STAT(STAT_BeamPathQueriesSegment3);
+		break;
+	}
+}
+
+void FBeamPath::Reset()
+{
+	Segments.Reset();
+	TargetHit = FHitResult();
+	bHit = false;
+	TargetDistance = 0.0f;
+	Length = 0.0f;
+	bTruncated = false;
+	Age = 0;
+	bCached = false;
+}
+
+FVector FBeamPath::GetPointAtDistance(float Distance) const
+{
+	if (Segments.Num() == 0)
+	{
+		return FVector::ZeroVector;
+	}
+
+	float travelled = 0.0f;
+	for (int32 i = 0; i < Segments.Num(); ++i)
+	{
+		const FBeamSegment& segment = Segments[i];
+		const float segmentLength = segment.GetLength();
+		// Last segment extrapolates so grabbed objects can be held past the hit
+		if (Distance <= travelled + segmentLength || i == Segments.Num() - 1)
+		{
+			const FVector direction = (segment.End - segment.Start).GetSafeNormal();
+			return segment.Start + direction * (Distance - travelled);
+		}
+		travelled += segmentLength;
+	}
+	return Segments.Last().End;
+}
+
+float FBeamPath::GetDistanceTo(const FVector& Point) const
+{
+	if (Segments.Num() == 0)
+	{
+		return 0.0f;
+	}
+
+	float travelled = 0.0f;
+	for (int32 i = 0; i < Segments.Num() - 1; ++i)
+	{
+		travelled += Segments[i].GetLength();
+	}
+	return travelled + (Point - Segments.Last().Start).Size();
+}
+
+FBeamPathTracer::FBeamPathTracer()
+	: MaxSegments(BEAM_PATH_MAX_SEGMENTS)
+	, ReflectiveTag(TEXT("Reflective"))
+	, CacheMaxFrames(3)
+	, CacheWatchDistance(100.0f)
+	, CachedStart(FVector::ZeroVector)
+	, CachedDirection(FVector::ZeroVector)
+	, CachedRange(0.0f)
+	, CachedFrame(0)
+{
+	ScratchHits.Reserve(8);
+	ScratchOverlaps.Reserve(16);
+}
+
+bool FBeamPathTracer::Trace(UWorld* World, const FVector& Start, const FVector& Direction, float Range, const FCollisionQueryParams& Params, FBeamPath& OutPath)
+{
+	if (World == nullptr)
+	{
+		return false;
+	}
+
+	// Nothing moved since last trace, reuse the path
+	if (IsCacheValid(World, Start, Direction, Range))
+	{
+		INC_DWORD_STAT(STAT_BeamPathCacheHits);
+		OutPath = CachedPath;
+		OutPath.Age = static_cast<int32>(GFrameCounter - CachedFrame);
+		OutPath.bCached = true;
+		return OutPath.bHit;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_BeamPathTrace);
+
+	OutPath.Reset();
+	TracedComponents.Reset();
+
+	FVector segmentStart = Start;
+	FVector direction = Direction.GetSafeNormal();
+	float remaining = Range;
+	const int32 maxSegments = FMath::Clamp(MaxSegments, 1, BEAM_PATH_MAX_SEGMENTS);
+
+	UBeamQuerySubsystem* scheduler = UBeamQuerySubsystem::Get(World);
+
+	for (int32 i = 0; i < maxSegments && remaining > KINDA_SMALL_NUMBER; ++i)
+	{
+		const FVector segmentEnd = segmentStart + direction * remaining;
+
+		// Glass overlaps visibility so it comes as touches before the blocking hit
+		ScratchHits.Reset();
+		bool bBlock = false;
+		if (scheduler != nullptr)
+		{
+			if (!scheduler->AimTraceMulti(ScratchHits, segmentStart, segmentEnd, ECollisionChannel::ECC_Visibility, Params, bBlock))
+			{
+				INC_DWORD_STAT(STAT_BeamPathBudgetExhausted);
+				// Out of budget before the first query, an old path is better than no path
+				if (i == 0 && CachedWorld.Get() == World && CachedPath.Segments.Num() > 0)
+				{
+					OutPath = CachedPath;
+					OutPath.Age = static_cast<int32>(GFrameCounter - CachedFrame);
+					OutPath.bCached = true;
+					OutPath.bTruncated = true;
+					return OutPath.bHit;
+				}
+				OutPath.bTruncated = true;
+				break;
+			}
+		}
+		else
+		{
+			bBlock = World->LineTraceMultiByChannel(ScratchHits, segmentStart, segmentEnd, ECollisionChannel::ECC_Visibility, Params);
+		}
+
+		INC_DWORD_STAT(STAT_BeamPathQueries);
+		IncSegmentQueryStat(i);
+
+		FBeamSegment& segment = OutPath.Segments.AddDefaulted_GetRef();
+		segment.Start = segmentStart;
+		segment.End = segmentEnd;
+		segment.QueryCount = 1;
+
+		for (const FHitResult& hit : ScratchHits)
+		{
+			UPrimitiveComponent* component = hit.GetComponent();
+			if (component == nullptr)
+			{
+				continue;
+			}
+			if (!hit.bBlockingHit && component->GetCollisionObjectType() == ECC_Glass)
+			{
+				segment.GlassCount++;
+			}
+			TracedComponents.Emplace(component, component->GetComponentTransform());
+		}
+
+		if (!bBlock)
+		{
+			OutPath.Length += remaining;
+			break;
+		}
+
+		// Blocking hit is always the last one
+		const FHitResult& blockingHit = ScratchHits.Last();
+		segment.End = blockingHit.Location;
+		OutPath.Length += blockingHit.Distance;
+		remaining -= blockingHit.Distance;
+
+		if (IsReflective(blockingHit) && i < maxSegments - 1)
+		{
+			// Bounce and keep going with the remaining range
+			direction = FMath::GetReflectionVector(direction, blockingHit.ImpactNormal);
+			segmentStart = blockingHit.Location + direction * KINDA_SMALL_NUMBER;
+			continue;
+		}
+
+		OutPath.TargetHit = blockingHit;
+		OutPath.TargetDistance = OutPath.Length;
+		OutPath.bHit = true;
+		break;
+	}
+
+	// A path whose surroundings are unknown is not reused
+	if (!OutPath.bTruncated && GatherWatchedComponents(World, Params, OutPath))
+	{
+		StoreCache(World, Start, Direction, Range, OutPath);
+	}
+	return OutPath.bHit;
+}
+
+void FBeamPathTracer::Invalidate()
+{
+	CachedWorld.Reset();
+	CachedPath.Reset();
+	CachedComponents.Reset();
+	WatchedComponents.Reset();
+}
+
+bool FBeamPathTracer::IsCacheValid(UWorld* World, const FVector& Start, const FVector& Direction, float Range)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BeamPathCacheCheck);
+
+	if (CachedWorld.Get() != World || CachedPath.Segments.Num() == 0 || GFrameCounter - CachedFrame > static_cast<uint64>(CacheMaxFrames))
+	{
+		return false;
+	}
+
+	if (!Start.Equals(CachedStart, 0.01f) || !Direction.Equals(CachedDirection, 1.e-4f) || Range != CachedRange)
+	{
+		return false;
+	}
+
+	// Everything the path touched must still be in the same place
+	for (const TPair<TWeakObjectPtr<UPrimitiveComponent>, FTransform>& entry : CachedComponents)
+	{
+		const UPrimitiveComponent* component = entry.Key.Get();
+		if (component == nullptr || !component->GetComponentTransform().Equals(entry.Value, 0.01f))
+		{
+			return false;
+		}
+	}
+
+	// Nor anything new on the way, clean stretches included
+	if (HasIntrusion())
+	{
+		INC_DWORD_STAT(STAT_BeamPathCacheIntrusions);
+		return false;
+	}
+	return true;
+}
+
+bool FBeamPathTracer::HasIntrusion() const
+{
+	// No scene query, only the bodies that moved are tested against the segments
+	for (const TPair<TWeakObjectPtr<UPrimitiveComponent>, FTransform>& entry : WatchedComponents)
+	{
+		const UPrimitiveComponent* component = entry.Key.Get();
+		if (component == nullptr || component->GetComponentTransform().Equals(entry.Value, 0.01f))
+		{
+			continue;
+		}
+
+		const FBox bounds = component->Bounds.GetBox();
+		for (const FBeamSegment& segment : CachedPath.Segments)
+		{
+			if (FMath::LineBoxIntersection(bounds, segment.Start, segment.End, segment.End - segment.Start))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool FBeamPathTracer::GatherWatchedComponents(UWorld* World, const FCollisionQueryParams& Params, const FBeamPath& Path)
+{
+	static const FCollisionObjectQueryParams watchedObjects = BeamPath::MakeWatchedObjects();
+
+	NearbyComponents.Reset();
+	UBeamQuerySubsystem* scheduler = UBeamQuerySubsystem::Get(World);
+	for (const FBeamSegment& segment : Path.Segments)
+	{
+		// Box along the segment, as far around it as a body may come from while the path is cached
+		const FVector delta = segment.End - segment.Start;
+		const float halfLength = delta.Size() * 0.5f;
+		if (halfLength < KINDA_SMALL_NUMBER)
+		{
+			continue;
+		}
+		const FQuat rotation = FRotationMatrix::MakeFromX(delta).ToQuat();
+		const FCollisionShape box = FCollisionShape::MakeBox(FVector(halfLength + CacheWatchDistance, CacheWatchDistance, CacheWatchDistance));
+		const FVector center = segment.Start + delta * 0.5f;
+
+		ScratchOverlaps.Reset();
+		if (scheduler != nullptr)
+		{
+			if (!scheduler->AimOverlapMulti(ScratchOverlaps, center, rotation, watchedObjects, box, Params))
+			{
+				INC_DWORD_STAT(STAT_BeamPathBudgetExhausted);
+				return false;
+			}
+		}
+		else
+		{
+			World->OverlapMultiByObjectType(ScratchOverlaps, center, rotation, watchedObjects, box, Params);
+		}
+
+		for (const FOverlapResult& overlap : ScratchOverlaps)
+		{
+			UPrimitiveComponent* component = overlap.GetComponent();
+			if (component == nullptr || component->GetCollisionResponseToChannel(ECC_Visibility) == ECR_Ignore)
+			{
+				continue;
+			}
+
+			// Bodies the path already went through or ended on are checked on their own
+			if (!BeamPath::ContainsComponent(TracedComponents, component) && !BeamPath::ContainsComponent(NearbyComponents, component))
+			{
+				NearbyComponents.Emplace(component, component->GetComponentTransform());
+			}
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_BeamPathWatchedBodies, NearbyComponents.Num());
+	return true;
+}
+
+void FBeamPathTracer::StoreCache(UWorld* World, const FVector& Start, const FVector& Direction, float Range, const FBeamPath& Path)
+{
+	CachedPath = Path;
+	CachedStart = Start;
+	CachedDirection = Direction;
+	CachedRange = Range;
+	CachedFrame = GFrameCounter;
+	CachedWorld = World;
+
+	// Glass panes, mirrors and the final blocking hit. Kept capacity, no allocation once grown
+	CachedComponents.Reset();
+	CachedComponents.Append(TracedComponents);
+	WatchedComponents.Reset();
+	WatchedComponents.Append(NearbyComponents);
+}
+
+bool FBeamPathTracer::IsReflective(const FHitResult& Hit) const
+{
+	const UPrimitiveComponent* component = Hit.GetComponent();
+	const AActor* actor = Hit.GetActor();
+	return (component != nullptr && component->ComponentHasTag(ReflectiveTag)) || (actor != nullptr && actor->ActorHasTag(ReflectiveTag));
+}
@@ -0,0 +1,148 @@
+// Tequila Works test
+#include "Beam/BeamProximityShell.h"
+
+#include "DiminuatorTypes.h"
+#include "Engine/World.h"
+
+namespace BeamProximityShell
+{
+	namespace
+	{
+		// Level geometry, glass walls and ceilings, scalable objects: bodies that often have overlap events off
+		FCollisionObjectQueryParams MakeStaticQueryObjects()
+		{
+			FCollisionObjectQueryParams objects(ECC_WorldStatic);
+			objects.AddObjectTypesToQuery(ECC_Glass);
+			objects.AddObjectTypesToQuery(ECC_Scalable);
+			return objects;
+		}
+	}
+}
+
+UBeamProximityShell::UBeamProximityShell()
+{
+	Inflation = 1.25f;
+	StaticQueryLocation = FVector::ZeroVector;
+
+	// Query only and invisible to the beam and projectiles, off until it tracks something
+	SetCollisionProfileName(TEXT("Trigger"));
+	// Trigger leaves the game channels to their default block, which hides glass and scalable bodies
+	SetCollisionResponseToChannel(ECC_Glass, ECR_Overlap);
+	SetCollisionResponseToChannel(ECC_Scalable, ECR_Overlap);
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetGenerateOverlapEvents(true);
+	SetCanEverAffectNavigation(false);
+	CanCharacterStepUpOn = ECB_No;
+
+	// Extent in world units whatever the scale of the target
+	SetUsingAbsoluteScale(true);
+
+	OnComponentBeginOverlap.AddDynamic(this, &UBeamProximityShell::OnShellBeginOverlap);
+	OnComponentEndOverlap.AddDynamic(this, &UBeamProximityShell::OnShellEndOverlap);
+}
+
+void UBeamProximityShell::Track(UPrimitiveComponent* NewTarget, float HalfExtent)
+{
+	if (Target.Get() != NewTarget)
+	{
+		StopTracking();
+
+		Target = NewTarget;
+		SetBoxExtent(FVector(HalfExtent * Inflation), false);
+		AttachToComponent(NewTarget, FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+		SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+
+		// Bodies already around count too, not only the ones coming in later
+		UpdateOverlaps();
+		UpdateStaticBodies(true);
+	}
+	else if (HalfExtent > GetUnscaledBoxExtent().X)
+	{
+		SetBoxExtent(FVector(HalfExtent * Inflation));
+		UpdateStaticBodies(true);
+	}
+	else
+	{
+		UpdateStaticBodies(false);
+	}
+}
+
+void UBeamProximityShell::UpdateStaticBodies(bool bForce)
+{
+	const UPrimitiveComponent* target = Target.Get();
+	UWorld* world = GetWorld();
+	if (target == nullptr || world == nullptr)
+	{
+		return;
+	}
+
+	// The probes reach the asked extent, the query covers the inflated one, so the target can move the difference
+	const FVector location = GetComponentLocation();
+	const float shellExtent = GetUnscaledBoxExtent().X;
+	const float slack = shellExtent - shellExtent / Inflation;
+	if (!bForce && FVector::DistSquared(location, StaticQueryLocation) <= FMath::Square(slack))
+	{
+		return;
+	}
+	StaticQueryLocation = location;
+
+	// Sphere around the box so the target can rotate freely too
+	FCollisionQueryParams params(SCENE_QUERY_STAT(BeamProximityShell), false, target->GetOwner());
+	ScratchOverlaps.Reset();
+	static const FCollisionObjectQueryParams staticObjects = BeamProximityShell::MakeStaticQueryObjects();
+	world->OverlapMultiByObjectType(ScratchOverlaps, location, FQuat::Identity, staticObjects, FCollisionShape::MakeSphere(GetUnscaledBoxExtent().Size()), params);
+
+	StaticBodies.Reset();
+	for (const FOverlapResult& overlap : ScratchOverlaps)
+	{
+		UPrimitiveComponent* component = overlap.GetComponent();
+		if (component != nullptr && IsProbeBlocker(component))
+		{
+			StaticBodies.AddUnique(component);
+		}
+	}
+}
+
+bool UBeamProximityShell::IsProbeBlocker(const UPrimitiveComponent* Component) const
+{
+	const UPrimitiveComponent* target = Target.Get();
+	if (target == nullptr || Component->GetOwner() == target->GetOwner())
+	{
+		return false;
+	}
+
+	// Glass and scalable bodies stop the probes unless their profile says otherwise
+	const ECollisionChannel objectType = Component->GetCollisionObjectType();
+	const ECollisionResponse response = Component->GetCollisionResponseToChannel(ECC_WorldStatic);
+	return response == ECR_Block || ((objectType == ECC_Glass || objectType == ECC_Scalable) && response != ECR_Ignore);
+}
+
+void UBeamProximityShell::StopTracking()
+{
+	if (Target.IsValid() || GetAttachParent() != nullptr)
+	{
+		// Ends every overlap before leaving
+		SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+	}
+	Target.Reset();
+	NearbyBodies.Reset();
+	StaticBodies.Reset();
+}
+
+void UBeamProximityShell::OnShellBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	if (OtherComp != nullptr && IsProbeBlocker(OtherComp))
+	{
+		NearbyBodies.AddUnique(OtherComp);
+	}
+}
+
+void UBeamProximityShell::OnShellEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	// Components with several bodies end one overlap per body, keep them until the last one
+	if (!IsOverlappingComponent(OtherComp))
+	{
+		NearbyBodies.RemoveSwap(OtherComp);
+	}
+}
@@ -0,0 +1,158 @@
+// Tequila Works test
+#include "Beam/BeamQuerySubsystem.h"
+
+#include "Diminuator.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Stress/ServerLoadReport.h"
+
+DECLARE_CYCLE_STAT(TEXT("Query Scheduler Tick"), STAT_BeamQuerySchedulerTick, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Aim Queries"), STAT_BeamAimQueries, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Aim Overlaps"), STAT_BeamAimOverlaps, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Aim Queries Over Budget"), STAT_BeamAimQueriesOverBudget, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred Queries"), STAT_BeamDeferredQueries, STATGROUP_Beam);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Queued Queries"), STAT_BeamQueuedQueries, STATGROUP_Beam);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Query Time (ms)"), STAT_BeamQueryTime, STATGROUP_Beam);
+
+static TAutoConsoleVariable<int32> CVarBeamQueryMaxPerFrame(
+	TEXT("beam.Query.MaxPerFrame"),
+	48,
+	TEXT("Max beam scene queries per frame, aim traces included."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarBeamQueryBudgetMs(
+	TEXT("beam.Query.BudgetMs"),
+	0.5f,
+	TEXT("Max time per frame spent on beam scene queries, aim traces included, in milliseconds. 0 disables the time budget."),
+	ECVF_Default);
+
+UBeamQuerySubsystem* UBeamQuerySubsystem::Get(const UWorld* World)
+{
+	return (World != nullptr) ? World->GetSubsystem<UBeamQuerySubsystem>() : nullptr;
+}
+
+bool UBeamQuerySubsystem::AimTraceMulti(TArray<FHitResult>& OutHits, const FVector& Start, const FVector& End, ECollisionChannel Channel, const FCollisionQueryParams& Params, bool& bOutBlock)
+{
+	UpdateFrameBudget();
+	if (!HasAimBudget())
+	{
+		return false;
+	}
+
+	const double startTime = FPlatformTime::Seconds();
+	bOutBlock = GetWorld()->LineTraceMultiByChannel(OutHits, Start, End, Channel, Params);
+	ChargeAimQuery(FPlatformTime::Seconds() - startTime);
+	INC_DWORD_STAT(STAT_BeamAimQueries);
+	return true;
+}
+
+bool UBeamQuerySubsystem::AimOverlapMulti(TArray<FOverlapResult>& OutOverlaps, const FVector& Position, const FQuat& Rotation, const FCollisionObjectQueryParams& ObjectParams, const FCollisionShape& Shape, const FCollisionQueryParams& Params)
+{
+	UpdateFrameBudget();
+	if (!HasAimBudget())
+	{
+		return false;
+	}
+
+	const double startTime = FPlatformTime::Seconds();
+	GetWorld()->OverlapMultiByObjectType(OutOverlaps, Position, Rotation, ObjectParams, Shape, Params);
+	ChargeAimQuery(FPlatformTime::Seconds() - startTime);
+	INC_DWORD_STAT(STAT_BeamAimOverlaps);
+	return true;
+}
+
+void UBeamQuerySubsystem::Enqueue(const TSharedRef<FBeamQuery>& Query)
+{
+	if (!Query->bPending)
+	{
+		Query->bPending = true;
+		PendingQueries.Add(Query);
+	}
+}
+
+void UBeamQuerySubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BeamQuerySchedulerTick);
+	LLM_SCOPED_TAG_WITH_STAT(STAT_BeamLLM, ELLMTracker::Default);
+	FBeamCpuScope beamCpuScope;
+
+	UpdateFrameBudget();
+
+	// Whatever did not fit waits for next frame, results just get older
+	int32 processed = 0;
+	while (processed < PendingQueries.Num() && HasBudget())
+	{
+		FBeamQuery& query = PendingQueries[processed].Get();
+		RunQuery(query);
+		processed++;
+	}
+	PendingQueries.RemoveAt(0, processed, false);
+
+	SET_DWORD_STAT(STAT_BeamQueuedQueries, PendingQueries.Num());
+}
+
+ETickableTickType UBeamQuerySubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UBeamQuerySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBeamQuerySubsystem, STATGROUP_Tickables);
+}
+
+void UBeamQuerySubsystem::UpdateFrameBudget()
+{
+	if (BudgetFrame != GFrameCounter)
+	{
+		BudgetFrame = GFrameCounter;
+		QueriesThisFrame = 0;
+		QuerySecondsThisFrame = 0.0;
+	}
+}
+
+bool UBeamQuerySubsystem::HasBudget() const
+{
+	const float budgetMs = CVarBeamQueryBudgetMs.GetValueOnGameThread();
+	return QueriesThisFrame < CVarBeamQueryMaxPerFrame.GetValueOnGameThread()
+		&& (budgetMs <= 0.0f || QuerySecondsThisFrame * 1000.0 < budgetMs);
+}
+
+bool UBeamQuerySubsystem::HasAimBudget() const
+{
+	// Aim runs before the queued queries so it is charged first, but the count and time caps
+	// still hold against a crowd of beams. The caller keeps its last result
+	if (!HasBudget())
+	{
+		INC_DWORD_STAT(STAT_BeamAimQueriesOverBudget);
+		return false;
+	}
+	return true;
+}
+
+void UBeamQuerySubsystem::ChargeAimQuery(double Elapsed)
+{
+	QueriesThisFrame++;
+	QuerySecondsThisFrame += Elapsed;
+	INC_FLOAT_STAT_BY(STAT_BeamQueryTime, Elapsed * 1000.0);
+}
+
+void UBeamQuerySubsystem::RunQuery(FBeamQuery& Query)
+{
+	// Same parameters for every query, only the ignored actor changes
+	QueryParams.ClearIgnoredActors();
+	QueryParams.AddIgnoredActor(Query.IgnoredActor.Get());
+
+	const double startTime = FPlatformTime::Seconds();
+	Query.bHit = GetWorld()->LineTraceSingleByChannel(ScratchHit, Query.Start, Query.End, Query.Channel, QueryParams);
+	const double elapsed = FPlatformTime::Seconds() - startTime;
+
+	Query.bHasResult = true;
+	Query.bPending = false;
+	Query.CompletedFrame = GFrameCounter;
+
+	QueriesThisFrame++;
+	QuerySecondsThisFrame += elapsed;
+	INC_DWORD_STAT(STAT_BeamDeferredQueries);
+	INC_FLOAT_STAT_BY(STAT_BeamQueryTime, elapsed * 1000.0);
+}
@@ -0,0 +1,216 @@
+// Tequila Works test
+#include "Beam/BeamSignificanceSubsystem.h"
+
+#include "Diminuator.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Components/BeamComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Significance Update"), STAT_BeamSignificanceUpdate, STATGROUP_Beam);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Beams High Significance"), STAT_BeamSignificanceHigh, STATGROUP_Beam);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Beams Medium Significance"), STAT_BeamSignificanceMedium, STATGROUP_Beam);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Beams Low Significance"), STAT_BeamSignificanceLow, STATGROUP_Beam);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Significance Saved Time (ms)"), STAT_BeamSignificanceSaved, STATGROUP_Beam);
+
+static TAutoConsoleVariable<int32> CVarBeamSignificanceEnable(
+	TEXT("beam.Significance.Enable"),
+	1,
+	TEXT("Lower the beam logic fidelity of far and unseen beams. 0 keeps every beam at full fidelity."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarBeamSignificanceHighDistance(
+	TEXT("beam.Significance.HighDistance"),
+	1500.0f,
+	TEXT("Visible beams closer than this to a local viewer are high significance."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarBeamSignificanceMediumDistance(
+	TEXT("beam.Significance.MediumDistance"),
+	4000.0f,
+	TEXT("Visible beams closer than this, or unseen beams closer than the high distance, are medium significance."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarBeamSignificanceMediumInterval(
+	TEXT("beam.Significance.MediumTickInterval"),
+	0.05f,
+	TEXT("Beam tick interval in seconds at medium significance."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarBeamSignificanceLowInterval(
+	TEXT("beam.Significance.LowTickInterval"),
+	0.2f,
+	TEXT("Beam tick interval in seconds at low significance."),
+	ECVF_Default);
+
+namespace BeamSignificance
+{
+	const float UpdateInterval = 0.1f;
+
+	// Seconds an actor counts as seen after its last render
+	const float RenderedTolerance = 0.25f;
+
+	float GetTickInterval(EBeamSignificance Significance)
+	{
+		switch (Significance)
+		{
+		case EBeamSignificance::Medium:
+			return CVarBeamSignificanceMediumInterval.GetValueOnGameThread();
+
+		case EBeamSignificance::Low:
+			return CVarBeamSignificanceLowInterval.GetValueOnGameThread();
+
+		default:
+			return 0.0f;
+		}
+	}
+}
+
+UBeamSignificanceSubsystem* UBeamSignificanceSubsystem::Get(const UWorld* World)
+{
+	return (World != nullptr) ? World->GetSubsystem<UBeamSignificanceSubsystem>() : nullptr;
+}
+
+void UBeamSignificanceSubsystem::RegisterBeam(UBeamComponent* Beam)
+{
+	Beams.AddUnique(Beam);
+}
+
+void UBeamSignificanceSubsystem::UnregisterBeam(UBeamComponent* Beam)
+{
+	Beams.RemoveSwap(Beam);
+}
+
+void UBeamSignificanceSubsystem::RecordCosmeticTick(EBeamSignificance Significance, uint64 Cycles)
+{
+	double& averageMs = CosmeticTickMs[static_cast<int32>(Significance)];
+	const double tickMs = FPlatformTime::ToMilliseconds64(Cycles);
+	averageMs = (averageMs > 0.0) ? FMath::Lerp(averageMs, tickMs, 0.05) : tickMs;
+}
+
+void UBeamSignificanceSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BeamSignificanceUpdate);
+
+	Beams.RemoveAllSwap([](const TWeakObjectPtr<UBeamComponent>& Beam) { return !Beam.IsValid(); });
+
+	UpdateTimer -= DeltaTime;
+	if (UpdateTimer <= 0.0f)
+	{
+		UpdateTimer = BeamSignificance::UpdateInterval;
+
+		TArray<FViewer, TInlineAllocator<4>> viewers;
+		if (CVarBeamSignificanceEnable.GetValueOnGameThread() != 0)
+		{
+			GatherViewers(viewers);
+		}
+
+		int32 tierCounts[static_cast<int32>(EBeamSignificance::Count)] = {};
+		for (const TWeakObjectPtr<UBeamComponent>& beam : Beams)
+		{
+			const EBeamSignificance significance = Evaluate(beam.Get(), viewers);
+			beam->SetSignificance(significance, BeamSignificance::GetTickInterval(significance));
+			tierCounts[static_cast<int32>(significance)]++;
+		}
+
+		SET_DWORD_STAT(STAT_BeamSignificanceHigh, tierCounts[static_cast<int32>(EBeamSignificance::High)]);
+		SET_DWORD_STAT(STAT_BeamSignificanceMedium, tierCounts[static_cast<int32>(EBeamSignificance::Medium)]);
+		SET_DWORD_STAT(STAT_BeamSignificanceLow, tierCounts[static_cast<int32>(EBeamSignificance::Low)]);
+	}
+
+	// Estimate: a slowed beam ticking every frame at high tier, minus its share of a tick at its own tier.
+	// Only cosmetic beams slow down, so both costs come from cosmetic ticks, none known yet counts nothing
+	const double highTickMs = CosmeticTickMs[static_cast<int32>(EBeamSignificance::High)];
+	double savedMs = 0.0;
+	for (const TWeakObjectPtr<UBeamComponent>& beam : Beams)
+	{
+		const float tickInterval = beam->GetComponentTickInterval();
+		if (beam->IsBeamActive() && tickInterval > 0.0f && highTickMs > 0.0)
+		{
+			const double tierTickMs = CosmeticTickMs[static_cast<int32>(beam->GetSignificance())];
+			savedMs += FMath::Max(highTickMs - tierTickMs * FMath::Min(DeltaTime / tickInterval, 1.0f), 0.0);
+		}
+	}
+	SET_FLOAT_STAT(STAT_BeamSignificanceSaved, savedMs);
+}
+
+ETickableTickType UBeamSignificanceSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UBeamSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBeamSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UBeamSignificanceSubsystem::GatherViewers(TArray<FViewer, TInlineAllocator<4>>& OutViewers) const
+{
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		const APlayerController* controller = it->Get();
+		if (controller == nullptr || !controller->IsLocalController())
+		{
+			continue;
+		}
+
+		FVector location;
+		FRotator rotation;
+		controller->GetPlayerViewPoint(location, rotation);
+		const float fov = (controller->PlayerCameraManager != nullptr) ? controller->PlayerCameraManager->GetFOVAngle() : 90.0f;
+
+		FViewer& viewer = OutViewers.AddDefaulted_GetRef();
+		viewer.Location = location;
+		viewer.Direction = rotation.Vector();
+		viewer.CosHalfFOV = FMath::Cos(FMath::DegreesToRadians(fov * 0.5f));
+		viewer.Pawn = controller->GetPawn();
+	}
+}
+
+EBeamSignificance UBeamSignificanceSubsystem::Evaluate(const UBeamComponent* Beam, const TArray<FViewer, TInlineAllocator<4>>& Viewers) const
+{
+	// Nobody watching on this machine, keep the results exactly as they were
+	if (Viewers.Num() == 0)
+	{
+		return EBeamSignificance::High;
+	}
+
+	const AActor* owner = Beam->GetOwner();
+	const FVector beamLocation = owner->GetActorLocation();
+	const bool bRendered = owner->WasRecentlyRendered(BeamSignificance::RenderedTolerance);
+	const float highDistance = CVarBeamSignificanceHighDistance.GetValueOnGameThread();
+	const float mediumDistance = CVarBeamSignificanceMediumDistance.GetValueOnGameThread();
+
+	// Most significant of all the views
+	EBeamSignificance significance = EBeamSignificance::Low;
+	for (const FViewer& viewer : Viewers)
+	{
+		// The player holding the beam always sees it
+		if (viewer.Pawn == owner)
+		{
+			return EBeamSignificance::High;
+		}
+
+		const FVector toBeam = beamLocation - viewer.Location;
+		const float distance = toBeam.Size();
+		const bool bInView = FVector::DotProduct(toBeam.GetSafeNormal(), viewer.Direction) >= viewer.CosHalfFOV;
+		const bool bVisible = bInView && bRendered;
+
+		if (bVisible && distance < highDistance)
+		{
+			return EBeamSignificance::High;
+		}
+		if ((bVisible && distance < mediumDistance) || distance < highDistance)
+		{
+			significance = EBeamSignificance::Medium;
+		}
+	}
+
+	// A held object follows the handle target, it can not wait for the low tick rate
+	if (significance == EBeamSignificance::Low && Beam->IsGrabbing())
+	{
+		significance = EBeamSignificance::Medium;
+	}
+	return significance;
+}
@@ -0,0 +1,277 @@
+// Tequila Works test
+#include "Components/BeamBotComponent.h"
+
+#include "DiminuatorCharacter.h"
+#include "Components/BeamComponent.h"
+#include "DiminuatorTypes.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogBeamBot, Log, All);
+
+UBeamBotComponent::UBeamBotComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+
+	WanderWeight = 1.0f;
+	DiminuateWeight = 2.0f;
+	AugmentWeight = 2.0f;
+	GrabComboWeight = 2.0f;
+	FireVolleyWeight = 1.0f;
+	MinActionTime = 1.0f;
+	MaxActionTime = 4.0f;
+	TargetSearchRadius = 1500.0f;
+	FireInterval = 0.3f;
+	AimSpeed = 6.0f;
+
+	Character = nullptr;
+	Action = EBeamBotAction::Wander;
+	ActionTime = 0.0f;
+	ActionTimer = 0.0f;
+	ActionStep = 0;
+	StepTimer = 0.0f;
+	WanderYaw = 0.0f;
+	AimWobblePhase = 0.0f;
+}
+
+void UBeamBotComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Safe cast because bot component is Within = DiminuatorCharacter
+	Character = Cast<ADiminuatorCharacter>(GetOwner());
+
+	int32 seed = static_cast<int32>(FPlatformTime::Cycles());
+	FParse::Value(FCommandLine::Get(), TEXT("BeamBotSeed="), seed);
+	Random.Initialize(seed);
+	UE_LOG(LogBeamBot, Display, TEXT("Beam bot started, seed %d"), seed);
+
+	StartAction();
+}
+
+void UBeamBotComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	EndAction();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UBeamBotComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (Character == nullptr || !Character->IsLocallyControlled())
+	{
+		return;
+	}
+
+	UpdateAction(DeltaTime);
+
+	ActionTimer += DeltaTime;
+	if (ActionTimer >= ActionTime)
+	{
+		EndAction();
+		StartAction();
+	}
+}
+
+void UBeamBotComponent::StartAction()
+{
+	const float weights[] = { WanderWeight, DiminuateWeight, AugmentWeight, GrabComboWeight, FireVolleyWeight };
+	float totalWeight = 0.0f;
+	for (float weight : weights)
+	{
+		totalWeight += FMath::Max(weight, 0.0f);
+	}
+
+	// Weighted pick
+	int32 picked = 0;
+	float roll = Random.FRandRange(0.0f, totalWeight);
+	for (int32 i = 0; i < UE_ARRAY_COUNT(weights); ++i)
+	{
+		roll -= FMath::Max(weights[i], 0.0f);
+		if (roll <= 0.0f)
+		{
+			picked = i;
+			break;
+		}
+	}
+
+	Action = static_cast<EBeamBotAction>(picked);
+	ActionTime = Random.FRandRange(MinActionTime, MaxActionTime);
+	ActionTimer = 0.0f;
+	ActionStep = 0;
+	StepTimer = 0.0f;
+
+	// Beams and shots go at objects, nothing around means a walk instead
+	Target = (Action != EBeamBotAction::Wander) ? FindTarget() : nullptr;
+	if (!Target.IsValid())
+	{
+		Action = EBeamBotAction::Wander;
+		WanderYaw = Random.FRandRange(-180.0f, 180.0f);
+	}
+
+	switch (Action)
+	{
+	case EBeamBotAction::Diminuate:
+		Character->StartBeam(BeamMode::DIMINUATOR);
+		break;
+
+	case EBeamBotAction::Augment:
+		Character->StartBeam(BeamMode::AUGMENTATOR);
+		break;
+
+	case EBeamBotAction::GrabCombo:
+		// Second trigger comes a moment later, like a player does
+		Character->StartBeam(BeamMode::DIMINUATOR);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void UBeamBotComponent::EndAction()
+{
+	if (Character == nullptr)
+	{
+		return;
+	}
+
+	switch (Action)
+	{
+	case EBeamBotAction::Diminuate:
+		Character->StopBeam(BeamMode::DIMINUATOR);
+		break;
+
+	case EBeamBotAction::Augment:
+		Character->StopBeam(BeamMode::AUGMENTATOR);
+		break;
+
+	case EBeamBotAction::GrabCombo:
+		// Release whatever is still pressed
+		if (ActionStep == 1)
+		{
+			Character->StopBeam(BeamMode::AUGMENTATOR);
+		}
+		Character->StopBeam(BeamMode::DIMINUATOR);
+		break;
+
+	default:
+		break;
+	}
+
+	Action = EBeamBotAction::Wander;
+	ActionStep = 0;
+}
+
+void UBeamBotComponent::UpdateAction(float DeltaTime)
+{
+	StepTimer += DeltaTime;
+
+	switch (Action)
+	{
+	case EBeamBotAction::Wander:
+		Steer(DeltaTime, false);
+		break;
+
+	case EBeamBotAction::Diminuate:
+	case EBeamBotAction::Augment:
+		Steer(DeltaTime, true);
+		break;
+
+	case EBeamBotAction::GrabCombo:
+		// 0: diminuator only, 1: both triggers (grab) dragging the object around, 2: back to diminuator
+		if (ActionStep == 0 && StepTimer > 0.2f)
+		{
+			Character->StartBeam(BeamMode::AUGMENTATOR);
+			ActionStep = 1;
+			WanderYaw = Character->GetControlRotation().Yaw + Random.FRandRange(-90.0f, 90.0f);
+		}
+		else if (ActionStep == 1 && ActionTimer > ActionTime * 0.75f)
+		{
+			Character->StopBeam(BeamMode::AUGMENTATOR);
+			ActionStep = 2;
+		}
+
+		if (ActionStep == 1)
+		{
+			// Dragging, the target follows the beam
+			Target = nullptr;
+		}
+		Steer(DeltaTime, ActionStep == 0);
+		break;
+
+	case EBeamBotAction::FireVolley:
+		Steer(DeltaTime, false);
+		if (StepTimer >= FireInterval)
+		{
+			Character->Fire();
+			StepTimer = 0.0f;
+		}
+		break;
+	}
+}
+
+AActor* UBeamBotComponent::FindTarget() const
+{
+	UWorld* const world = GetWorld();
+	if (world == nullptr)
+	{
+		return nullptr;
+	}
+
+	// Scalable objects, plus plain physics bodies not registered yet
+	FCollisionObjectQueryParams objectParams;
+	objectParams.AddObjectTypesToQuery(ECC_Scalable);
+	objectParams.AddObjectTypesToQuery(ECC_PhysicsBody);
+
+	TArray<FOverlapResult> overlaps;
+	FCollisionQueryParams params(SCENE_QUERY_STAT(BeamBotTarget), false, GetOwner());
+	world->OverlapMultiByObjectType(overlaps, GetOwner()->GetActorLocation(), FQuat::Identity, objectParams, FCollisionShape::MakeSphere(TargetSearchRadius), params);
+
+	TArray<AActor*, TInlineAllocator<16>> candidates;
+	for (const FOverlapResult& overlap : overlaps)
+	{
+		const UPrimitiveComponent* component = overlap.GetComponent();
+		if (component != nullptr && component->IsSimulatingPhysics() && overlap.GetActor() != nullptr)
+		{
+			candidates.AddUnique(overlap.GetActor());
+		}
+	}
+
+	return (candidates.Num() > 0) ? candidates[Random.RandHelper(candidates.Num())] : nullptr;
+}
+
+void UBeamBotComponent::Steer(float DeltaTime, bool bApproach)
+{
+	AController* controller = Character->GetController();
+	if (controller == nullptr)
+	{
+		return;
+	}
+
+	// Aim at the target with some hand wobble, or look towards the wander direction
+	const FRotator current = controller->GetControlRotation();
+	FRotator desired(0.0f, WanderYaw, 0.0f);
+	float distance = 0.0f;
+	if (Target.IsValid())
+	{
+		const FVector toTarget = Target->GetActorLocation() - Character->GetPawnViewLocation();
+		desired = toTarget.Rotation();
+		distance = toTarget.Size();
+	}
+
+	AimWobblePhase += DeltaTime;
+	desired.Pitch += FMath::Sin(AimWobblePhase * 2.3f) * 2.0f;
+	desired.Yaw += FMath::Sin(AimWobblePhase * 1.7f) * 3.0f;
+	controller->SetControlRotation(FMath::RInterpTo(current, desired, DeltaTime, AimSpeed));
+
+	// Walk until the target is in beam range, always walk when wandering
+	const UBeamComponent* beam = Character->GetBeamComponent();
+	const float range = (beam != nullptr) ? beam->BeamRange * 0.75f : 0.0f;
+	if (!Target.IsValid() || (bApproach && distance > range))
+	{
+		Character->AddMovementInput(FRotator(0.0f, current.Yaw, 0.0f).Vector(), 1.0f);
+	}
+}
@@ -1,12 +1,142 @@
 // Tequila Works test
 #include "Components/BeamComponent.h"
 
+#include "Diminuator.h"
 #include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
 #include "DrawDebugHelpers.h"
 #include "DiminuatorCharacter.h"
 #include "PhysicsEngine/PhysicsHandleComponent.h"
 #include "Components/MeshComponent.h"
-#include "TimerManager.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "MotionControllerComponent.h"
+#include "IMotionController.h"
+#include "Features/IModularFeatures.h"
+#include "Stress/ServerLoadReport.h"
+#include "Beam/BeamEventLog.h"
+#include "Beam/BeamProximityShell.h"
+#include "Net/UnrealNetwork.h"
+#include "Interfaces/Scalable.h"
+#include "Components/ScalableComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "BeamClearance.h"
+#include "RenderingThread.h"
+#include "RHICommandList.h"
+
+#include <atomic>
+
+DECLARE_CYCLE_STAT(TEXT("Beam Tick"), STAT_BeamTick, STATGROUP_Beam);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Motion To Beam Latency (ms)"), STAT_BeamMotionLatency, STATGROUP_Beam);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Drawn Pose Age On Game Thread (ms)"), STAT_BeamDrawnPoseAge, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scale Preview Frames"), STAT_BeamScalePreviewFrames, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Collision Scale Commits"), STAT_BeamCollisionCommits, STATGROUP_Beam);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Collision Rebuilds Without Preview"), STAT_BeamRebuildsWithoutPreview, STATGROUP_Beam);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Collision Rebuilds"), STAT_BeamRebuilds, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Clearance Checks"), STAT_BeamClearanceChecks, STATGROUP_Beam);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Clearance Checks Skipped"), STAT_BeamClearanceSkipped, STATGROUP_Beam);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Clearance Skipped (%)"), STAT_BeamClearanceSkippedPercent, STATGROUP_Beam);
+
+static TAutoConsoleVariable<int32> CVarBeamLatencySampleFrames(
+	TEXT("beam.LatencySampleFrames"),
+	30,
+	TEXT("Beam frames between motion to beam latency measurements on the RHI thread. 0 disables them."),
+	ECVF_Default);
+
+namespace BeamClearanceStats
+{
+	namespace
+	{
+		// Scale up ticks of every beam this frame
+		uint64 Frame = 0;
+		int32 Checks = 0;
+		int32 Skipped = 0;
+
+		void Record(bool bSkipped)
+		{
+			if (Frame != GFrameCounter)
+			{
+				Frame = GFrameCounter;
+				Checks = 0;
+				Skipped = 0;
+			}
+			Checks++;
+			Skipped += bSkipped ? 1 : 0;
+
+			INC_DWORD_STAT(STAT_BeamClearanceChecks);
+			if (bSkipped)
+			{
+				INC_DWORD_STAT(STAT_BeamClearanceSkipped);
+			}
+			SET_FLOAT_STAT(STAT_BeamClearanceSkippedPercent, 100.0f * Skipped / Checks);
+		}
+	}
+}
+
+/* Age of the drawn aim pose when the RHI thread submits its frame, read back on the game thread */
+struct FBeamPresentedPoseAge
+{
+	std::atomic<float> Seconds{ 0.0f };
+
+	// A measurement is on its way, no new one until it lands
+	std::atomic<bool> bPending{ false };
+};
+
+namespace BeamCoreBridge
+{
+	namespace
+	{
+		// Contacts older than this do not block the grabbed object anymore
+		const float StuckContactTolerance = 0.2f;
+
+		// Contact normal against the way to the handle target, about 75 degrees
+		const float StuckBlockingAngleCos = 0.25f;
+
+		static_assert(static_cast<int32>(BeamCore::EBeamMode::Off) == BeamMode::OFF, "BeamCore::EBeamMode must match BeamMode");
+
+		BeamCore::EBeamMode ToCore(BeamMode Mode) { return static_cast<BeamCore::EBeamMode>(Mode); }
+		BeamMode FromCore(BeamCore::EBeamMode Mode) { return static_cast<BeamMode>(Mode); }
+		BeamCore::FBeamVector ToCore(const FVector& V) { return BeamCore::FBeamVector(V.X, V.Y, V.Z); }
+		FVector FromCore(const BeamCore::FBeamVector& V) { return FVector(V.X, V.Y, V.Z); }
+		BeamCore::FBeamQuat ToCore(const FQuat& Q) { return BeamCore::FBeamQuat(Q.X, Q.Y, Q.Z, Q.W); }
+
+		/*
+		* Clearance probes of the beam core, run by the query scheduler
+		*/
+		class FScheduledProbeQueries : public BeamCore::IBeamProbeQueries
+		{
+		public:
+
+			FScheduledProbeQueries(TArray<TSharedRef<FBeamQuery>>& InQueries, const AActor* InIgnoredActor)
+				: Queries(InQueries)
+				, IgnoredActor(InIgnoredActor)
+			{
+			}
+
+			virtual bool GetProbeResult(int32_t Index, int32_t& OutAge, bool& bOutHit) const override
+			{
+				const FBeamQuery& query = Queries[Index].Get();
+				OutAge = query.GetAge();
+				bOutHit = query.bHit;
+				return query.bHasResult;
+			}
+
+			virtual void SubmitProbe(int32_t Index, const BeamCore::FBeamVector& Start, const BeamCore::FBeamVector& End) override
+			{
+				FBeamQuery& query = Queries[Index].Get();
+				query.Start = FromCore(Start);
+				query.End = FromCore(End);
+				query.Channel = ECollisionChannel::ECC_WorldStatic;
+				query.IgnoredActor = IgnoredActor;
+			}
+
+		private:
+
+			TArray<TSharedRef<FBeamQuery>>& Queries;
+			const AActor* IgnoredActor;
+		};
+	}
+}
 
 // Sets default values for this component's properties
 UBeamComponent::UBeamComponent()
@@ -19,13 +149,35 @@ UBeamComponent::UBeamComponent()
 	GunOffset = FVector(100.0f, 0.0f, 10.0f);
 
 	BeamState = BeamMode::OFF;
+	SetIsReplicatedByDefault(true);
 	BeamRange = 100.0f;
 	BeamImpulse = 100.0f;
 	BeamScaleSpeed = 5.0f;
 	BeamThickness = 3.0f;
 	GrabLinearDamping = 60.0f;
 	DisconnectionTime = 1.0f;
+	StuckTrackingError = 50.0f;
 	MinSize = 0.3f;
+	bLateUpdate = true;
+	BeamLength = 0.0f;
+	MaxBeamSegments = 3;
+	MaxClearanceAge = 2;
+	ScaleCommitDistance = 50.0f;
+	ScaleCommitInterval = 0.25f;
+	LastCommitTime = 0.0f;
+	PreviewComponent = nullptr;
+	PreviewScale = FVector::OneVector;
+	bPreviewTargetSimulated = false;
+	CommittedScale = FVector::OneVector;
+	bBeamPending = false;
+	bClearanceSphere = false;
+	bProximityShell = true;
+	ProximityShell = nullptr;
+	Significance = EBeamSignificance::High;
+	SignificanceSubsystem = nullptr;
+	MotionToBeamLatency = 0.0f;
+	LatencySampleCountdown = 0;
+	bTrackedNotifiedCollision = false;
 
 	// Physics handle 
 	PhysicsHandleComponent = CreateDefaultSubobject<UPhysicsHandleComponent>(TEXT("PhysicsHandleComponent"));
@@ -41,6 +193,54 @@ void UBeamComponent::BeginPlay()
 
 	// Safe cast because beam component is Within = DiminuatorCharacter
 	Character = Cast<ADiminuatorCharacter>(GetOwner());
+
+	// Aim with this frame controller pose instead of last frame one
+	if (Character != nullptr && Character->GetR_MotionController() != nullptr)
+	{
+		AddTickPrerequisiteComponent(Character->GetR_MotionController());
+	}
+
+	LateUpdateHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UBeamComponent::LateUpdateBeam);
+	PresentedPoseAge = MakeShared<FBeamPresentedPoseAge, ESPMode::ThreadSafe>();
+
+	// Aim trace parameters never change, build them once
+	AimQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(BeamAim), false, GetOwner());
+
+	SignificanceSubsystem = UBeamSignificanceSubsystem::Get(GetWorld());
+	if (SignificanceSubsystem != nullptr)
+	{
+		SignificanceSubsystem->RegisterBeam(this);
+	}
+}
+
+void UBeamComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(LateUpdateHandle);
+	LateUpdateHandle.Reset();
+
+	if (SignificanceSubsystem != nullptr)
+	{
+		SignificanceSubsystem->UnregisterBeam(this);
+		SignificanceSubsystem = nullptr;
+	}
+
+	// Leave the scaled component with its final collision and physics back on
+	EndScalePreview();
+	StopStuckTracking();
+
+	if (PreviewComponent != nullptr)
+	{
+		PreviewComponent->DestroyComponent();
+		PreviewComponent = nullptr;
+	}
+
+	if (ProximityShell != nullptr)
+	{
+		ProximityShell->DestroyComponent();
+		ProximityShell = nullptr;
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
@@ -51,23 +251,69 @@ void UBeamComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorC
 	// Beam is firing
 	if (IsBeamActive())
 	{
+		SCOPE_CYCLE_COUNTER(STAT_BeamTick);
+		LLM_SCOPED_TAG_WITH_STAT(STAT_BeamLLM, ELLMTracker::Default);
+		FBeamCpuScope beamCpuScope;
+
+		const uint64 startCycles = FPlatformTime::Cycles64();
 		ShootBeam(DeltaTime);
+		if (SignificanceSubsystem != nullptr && !IsSimulationOwner())
+		{
+			SignificanceSubsystem->RecordCosmeticTick(Significance, FPlatformTime::Cycles64() - startCycles);
+		}
+	}
+}
+
+void UBeamComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// The owner has both already
+	DOREPLIFETIME_CONDITION(UBeamComponent, BeamState, COND_SkipOwner);
+	DOREPLIFETIME_CONDITION(UBeamComponent, RemoteAimPose, COND_SkipOwner);
+}
+
+void UBeamComponent::SetSignificance(EBeamSignificance NewSignificance, float TickInterval)
+{
+	Significance = NewSignificance;
+
+	// Scaling and grabbing results must not depend on who watches, only cosmetic beams slow down
+	SetComponentTickInterval(IsSimulationOwner() ? 0.0f : TickInterval);
+
+	// Nothing left to draw
+	if (Significance == EBeamSignificance::Low)
+	{
+		bBeamPending = false;
 	}
 }
 
+bool UBeamComponent::IsSimulationOwner() const
+{
+	const AActor* owner = GetOwner();
+	return (owner != nullptr && owner->HasAuthority()) || (Character != nullptr && Character->IsLocallyControlled());
+}
+
 void UBeamComponent::OnStartFire(BeamMode Mode)
 {
+	LLM_SCOPED_TAG_WITH_STAT(STAT_BeamLLM, ELLMTracker::Default);
 	UpdateBeamState(Mode);
 }
 
 void UBeamComponent::OnStopFire(BeamMode Mode)
 {
+	LLM_SCOPED_TAG_WITH_STAT(STAT_BeamLLM, ELLMTracker::Default);
 	UpdateBeamState(Mode);
 
 	// If beam is off release any grabbed object
 	if (!IsBeamActive())
 	{
 		TryReleaseObject();
+		EndScalePreview();
+		if (ProximityShell != nullptr)
+		{
+			ProximityShell->StopTracking();
+		}
+		bBeamPending = false;
 	}
 }
 
@@ -76,77 +322,275 @@ void UBeamComponent::ShootBeam(float DeltaTime)
 	UWorld* const world = GetWorld();
 	if (world != nullptr)
 	{
-		if (Character != nullptr)
+		FBeamAimPose pose;
+		if (SampleAimPose(pose, false))
 		{
-			FHitResult outHit;
-			const FRotator spawnRotation = Character->GetControlRotation();
+			AimPose = pose;
+
+			// The server beam follows this aim, other clients draw with it
+			const bool bAuthority = GetOwner()->HasAuthority();
+			const bool bLocalAim = Character == nullptr || Character->IsLocallyControlled();
+			if (!bAuthority && bLocalAim && (!pose.Location.Equals(SentAimPose.Location, 0.1f) || !pose.Rotation.Equals(SentAimPose.Rotation, 0.01f)))
+			{
+				SentAimPose = pose;
+				ServerSetAimPose(pose);
+			}
+
 			// The start location of the beam, important for all the logic
-			Start = (Character->GetFP_MuzzleLocation() != nullptr) ?
-				Character->GetFP_MuzzleLocation()->GetComponentLocation() :
-				GetOwner()->GetActorLocation() + spawnRotation.RotateVector(GunOffset);
-			// The end location of line trace is start added with the rotation vector gives forward vector in any rotation
-			FVector end = Start + (spawnRotation.Vector() * BeamRange);
-			FCollisionQueryParams params;
-			params.AddIgnoredActor(GetOwner());
+			Start = pose.Location;
+			const FVector direction = pose.Rotation.Vector();
 			
-			// Launch beam searching for objects
-			bool bHit = world->LineTraceSingleByChannel(outHit, Start, end, ECollisionChannel::ECC_Visibility, params);
+			// Launch beam searching for objects, through glass and bouncing on reflective surfaces
+			PathTracer.MaxSegments = MaxBeamSegments;
+			bool bHit = PathTracer.Trace(world, Start, direction, BeamRange, AimQueryParams, BeamPath);
+
+			// Scale preview only lives while scaling the same component
+			if (PreviewTarget.IsValid() && (!bHit || BeamState == BeamMode::GRAB || BeamPath.TargetHit.GetComponent() != PreviewTarget.Get()))
+			{
+				EndScalePreview();
+			}
+
+			// So does the proximity shell
+			UPrimitiveComponent* shellTarget = (ProximityShell != nullptr) ? ProximityShell->GetTarget() : nullptr;
+			if (shellTarget != nullptr && (!bHit || BeamState == BeamMode::GRAB || BeamPath.TargetHit.GetComponent() != shellTarget))
+			{
+				ProximityShell->StopTracking();
+			}
+
 			if (bHit)
 			{
 				// Lets make sure hit component is valid
+				const FHitResult& outHit = BeamPath.TargetHit;
 				AActor* hitActor = outHit.GetActor();
 				HitComponent = outHit.GetComponent();
 				if ((hitActor != nullptr) && (hitActor != GetOwner()) && (HitComponent != nullptr))
 				{
-					// A) Physics actor transformations
-					if (HitComponent->IsSimulatingPhysics())
+					// Scalable actor transformations, previewed components are frozen while scaling.
+					// Scale and grab replicate from the server, the other beams are only drawn
+					if (bAuthority && (IsScalable(HitComponent) || HitComponent == PreviewTarget.Get()))
 					{
 						BeamPhysicsLogic(DeltaTime);
 					}
-					// B) Static actor non interactuable
-					else
-					{
-						// Dropping logic only if physics handle is active
-						if (PhysicsHandleComponent->IsActive())
-						{
-							float hitDistance = (Start - outHit.Location).Size();
-							BeamStaticLogic(hitDistance);
-						}
-					}
 				}
 			}
 
+			// Stuck check against last tick target, before it moves, it can release the object
+			if (IsGrabbing())
+			{
+				UpdateStuckDetection(DeltaTime);
+			}
+
 			// Track grabbed object
-			if (PhysicsHandleComponent->IsActive() && PhysicsHandleComponent->GetGrabbedComponent() != nullptr)
+			if (IsGrabbing())
 			{
-				FVector grabEnd = Start + (spawnRotation.Vector() * GrabDistance);
+				FVector grabEnd = BeamPath.GetPointAtDistance(GrabDistance);
 				PhysicsHandleComponent->SetTargetLocationAndRotation(grabEnd, PhysicsHandleComponent->GetGrabbedComponent()->GetComponentRotation());
-				BeamEffects(Start, grabEnd);	// Play beam effect
+				BeamLength = GrabDistance;
 			}
 			else
 			{
-				BeamEffects(Start, (bHit ? outHit.Location : end));	// Play beam effect
+				BeamLength = bHit ? BeamPath.TargetDistance : BeamPath.Length;
 			}
 
+			// Motion controllers keep moving until render, wait for the late update to play the effect.
+			// Beams not significant enough to be drawn skip both
+			if (Significance == EBeamSignificance::Low)
+			{
+				bBeamPending = false;
+			}
+			else if (bLateUpdate && bLocalAim && (AimPoseSource.IsBound() || (Character != nullptr && Character->bUsingMotionControllers)))
+			{
+				bBeamPending = true;
+			}
+			else
+			{
+				BeamEffects(FTransform::Identity);	// Play beam effect
+				MeasureMotionToBeamLatency(pose.SampleTime);
+			}
+		}
+	}
+}
+
+bool UBeamComponent::SampleAimPose(FBeamAimPose& OutPose, bool bLatest) const
+{
+	// Simulated or external source has priority
+	if (AimPoseSource.IsBound() && AimPoseSource.Execute(OutPose))
+	{
+		if (OutPose.SampleTime <= 0.0)
+		{
+			OutPose.SampleTime = FPlatformTime::Seconds();
+		}
+		return true;
+	}
+
+	if (Character == nullptr)
+	{
+		return false;
+	}
+
+	// Remote player, the local controllers and camera are not theirs. Nothing received yet uses the character aim
+	if (!Character->IsLocallyControlled() && RemoteAimPose.SampleTime > 0.0)
+	{
+		OutPose = RemoteAimPose;
+		return true;
+	}
+
+	OutPose.SampleTime = FPlatformTime::Seconds();
+
+	// VR: aim from the gun attached to the right hand
+	UMotionControllerComponent* controller = Character->GetR_MotionController();
+	USceneComponent* muzzle = Character->GetVR_MuzzleLocation();
+	if (Character->bUsingMotionControllers && controller != nullptr && muzzle != nullptr)
+	{
+		FTransform muzzleTransform = muzzle->GetComponentTransform();
+		FTransform controllerTransform;
+		if (bLatest && PollMotionControllerTransform(controllerTransform))
+		{
+			// Keep the muzzle offset from the hand and move it with the fresh hand pose
+			muzzleTransform = muzzleTransform.GetRelativeTransform(controller->GetComponentTransform()) * controllerTransform;
 		}
+		OutPose.Location = muzzleTransform.GetLocation();
+		OutPose.Rotation = muzzleTransform.Rotator();
+		return true;
+	}
+
+	OutPose.Rotation = Character->GetControlRotation();
+	OutPose.Location = (Character->GetFP_MuzzleLocation() != nullptr) ?
+		Character->GetFP_MuzzleLocation()->GetComponentLocation() :
+		GetOwner()->GetActorLocation() + OutPose.Rotation.RotateVector(GunOffset);
+	return true;
+}
+
+void UBeamComponent::ServerSetAimPose_Implementation(const FBeamAimPose& Pose)
+{
+	RemoteAimPose = Pose;
+	RemoteAimPose.SampleTime = FPlatformTime::Seconds();
+}
+
+void UBeamComponent::OnRep_BeamState()
+{
+	// Turned off on the server, nothing left to draw
+	if (!IsBeamActive())
+	{
+		bBeamPending = false;
+	}
+}
+
+void UBeamComponent::OnRep_RemoteAimPose()
+{
+	RemoteAimPose.SampleTime = FPlatformTime::Seconds();
+}
+
+bool UBeamComponent::PollMotionControllerTransform(FTransform& OutTransform) const
+{
+	UMotionControllerComponent* controller = Character->GetR_MotionController();
+	const float worldToMeters = GetWorld()->GetWorldSettings()->WorldToMeters;
+
+	// Walk the features by index, getting the implementations array allocates
+	IModularFeatures& modularFeatures = IModularFeatures::Get();
+	const int32 numControllers = modularFeatures.GetModularFeatureImplementationCount(IMotionController::GetModularFeatureName());
+	for (int32 i = 0; i < numControllers; ++i)
+	{
+		IMotionController* motionController = static_cast<IMotionController*>(modularFeatures.GetModularFeatureImplementation(IMotionController::GetModularFeatureName(), i));
+		FRotator orientation;
+		FVector position;
+		if (motionController != nullptr && motionController->GetControllerOrientationAndPosition(controller->PlayerIndex, controller->MotionSource, orientation, position, worldToMeters))
+		{
+			// Tracking pose is relative to the component the controller is attached to
+			const FTransform trackingTransform(orientation, position, controller->GetRelativeScale3D());
+			OutTransform = (controller->GetAttachParent() != nullptr) ?
+				trackingTransform * controller->GetAttachParent()->GetComponentTransform() :
+				trackingTransform;
+			return true;
+		}
+	}
+	return false;
+}
+
+void UBeamComponent::LateUpdateBeam(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (!bBeamPending || World != GetWorld())
+	{
+		return;
+	}
+	bBeamPending = false;
+
+	SCOPE_CYCLE_COUNTER(STAT_BeamTick);
+	LLM_SCOPED_TAG_WITH_STAT(STAT_BeamLLM, ELLMTracker::Default);
+	FBeamCpuScope beamCpuScope;
+
+	FBeamAimPose latestPose;
+	if (!SampleAimPose(latestPose, true))
+	{
+		latestPose = AimPose;
 	}
+
+	// Move the traced path rigidly from the traced muzzle pose to the latest one
+	const FTransform tracedTransform(AimPose.Rotation, AimPose.Location);
+	const FTransform latestTransform(latestPose.Rotation, latestPose.Location);
+	const FTransform correction = tracedTransform.GetRelativeTransformReverse(latestTransform);
+
+	// Physics handle target is consumed on next physics step, give it the fresh pose too
+	if (PhysicsHandleComponent->IsActive() && PhysicsHandleComponent->GetGrabbedComponent() != nullptr)
+	{
+		const FVector latestEnd = correction.TransformPosition(BeamPath.GetPointAtDistance(GrabDistance));
+		PhysicsHandleComponent->SetTargetLocationAndRotation(latestEnd, PhysicsHandleComponent->GetGrabbedComponent()->GetComponentRotation());
+	}
+
+	BeamEffects(correction);	// Play beam effect
+	MeasureMotionToBeamLatency(latestPose.SampleTime);
 }
 
+void UBeamComponent::MeasureMotionToBeamLatency(double SampleTime)
+{
+	// The game thread runs a frame or more ahead of the screen, the pose is timed again when the RHI thread
+	// submits the frame. Two commands per measurement, so only every few frames
+	const int32 sampleFrames = CVarBeamLatencySampleFrames.GetValueOnGameThread();
+	if (sampleFrames > 0 && --LatencySampleCountdown <= 0 && !PresentedPoseAge->bPending.load(std::memory_order_acquire))
+	{
+		LatencySampleCountdown = sampleFrames;
+		PresentedPoseAge->bPending.store(true, std::memory_order_relaxed);
+
+		// Same state every time, kept alive by the commands if the beam goes away first
+		TSharedPtr<FBeamPresentedPoseAge, ESPMode::ThreadSafe> poseAge = PresentedPoseAge;
+		ENQUEUE_RENDER_COMMAND(BeamPresentedPoseAge)(
+			[poseAge, SampleTime](FRHICommandListImmediate& RHICmdList)
+			{
+				RHICmdList.EnqueueLambda([poseAge, SampleTime](FRHICommandListImmediate&)
+				{
+					poseAge->Seconds.store(static_cast<float>(FPlatformTime::Seconds() - SampleTime), std::memory_order_relaxed);
+					poseAge->bPending.store(false, std::memory_order_release);
+				});
+			});
+	}
+
+	// Last frame measured, this one reaches the RHI thread a frame or two later
+	MotionToBeamLatency = PresentedPoseAge->Seconds.load(std::memory_order_relaxed);
+	SET_FLOAT_STAT(STAT_BeamMotionLatency, MotionToBeamLatency * 1000.0f);
+	SET_FLOAT_STAT(STAT_BeamDrawnPoseAge, (FPlatformTime::Seconds() - SampleTime) * 1000.0f);
+}
 
 void UBeamComponent::BeamPhysicsLogic(float DeltaTime)
 {
+	// Keeps the object awake on the network with a priority boost while it is beamed
+	UScalableComponent* scalableComponent = Cast<UScalableComponent>(GetScalable(HitComponent));
+	if (scalableComponent != nullptr)
+	{
+		scalableComponent->NotifyBeamed(Start);
+	}
+
 	// Grabbing Mode
 	if (BeamState == BeamMode::GRAB)
 	{
-		// We found an object, reset disconnection timer
-		GetWorld()->GetTimerManager().ClearTimer(StuckTimerHandle);
-		// If its a new object update physics handler
-		if (HitComponent != PhysicsHandleComponent->GetGrabbedComponent())
+		// If its a new object update physics handler, only physics objects can be grabbed
+		if (HitComponent != PhysicsHandleComponent->GetGrabbedComponent() && HitComponent->IsSimulatingPhysics())
 		{
 			PhysicsHandleComponent->SetActive(true);
 			PhysicsHandleComponent->GrabComponentAtLocationWithRotation(HitComponent, NAME_None, HitComponent->GetComponentLocation(), HitComponent->GetComponentRotation());
 			// Grab distance needed for knowing if hits are behind or in front of the component
-			GrabDistance = (Start - HitComponent->GetComponentLocation()).Size();
+			GrabDistance = BeamPath.GetDistanceTo(HitComponent->GetComponentLocation());
+			StartStuckTracking(HitComponent);
+			FBeamEventLog::Record(EBeamEventType::Grab, GetOwner(), HitComponent->GetOwner(), HitComponent->GetComponentLocation(), GrabDistance, BeamState);
 		}
 	}
 	// Scaling Mode
@@ -154,86 +598,280 @@ void UBeamComponent::BeamPhysicsLogic(float DeltaTime)
 	{
 		// Release object if physics handler active
 		TryReleaseObject();
-		FVector newScale3D = HitComponent->GetRelativeScale3D() + GetBeamScale(BeamState) * DeltaTime;
+		const FVector currentScale3D = GetVisualScale(HitComponent);
+		FVector newScale3D = currentScale3D + GetBeamScale(BeamState) * DeltaTime;
 		// If scaling up and collisions are clear or if scaling down and not min size reached
-		if(CheckScalingConditions(newScale3D))
+		if(CheckScalingConditions(currentScale3D, newScale3D))
+		{
+			UpdateScalePreview(HitComponent, newScale3D);
+		}
+		else if (newScale3D.X > currentScale3D.X)
 		{
-			// turn off physics before scale for cool effect of freeze in the air
-			HitComponent->SetSimulatePhysics(false);
-			HitComponent->SetRelativeScale3D(newScale3D);
-			// turn on physics to recalculate collisions in physics step
-			HitComponent->SetSimulatePhysics(true);
+			FBeamEventLog::Record(EBeamEventType::ScaleBlocked, GetOwner(), HitComponent->GetOwner(), HitComponent->GetComponentLocation(), currentScale3D.X, BeamState);
 		}
 	}
 }
 
-void UBeamComponent::BeamStaticLogic(float HitDistance)
+FVector UBeamComponent::GetVisualScale(UPrimitiveComponent* Component) const
+{
+	return (Component == PreviewTarget.Get()) ? PreviewScale : Component->GetRelativeScale3D();
+}
+
+void UBeamComponent::UpdateScalePreview(UPrimitiveComponent* Component, const FVector& NewScale)
 {
-	// If we hit something in between then release the cube inmediately
-	if (HitDistance <= GrabDistance)
+	LLM_SCOPED_TAG_WITH_STAT(STAT_BeamScalingLLM, ELLMTracker::Default);
+	UStaticMeshComponent* sourceMesh = Cast<UStaticMeshComponent>(Component);
+
+	// Only static meshes can be previewed, anything else is scaled directly
+	if (sourceMesh == nullptr)
 	{
-		TryReleaseObject();
+		// turn off physics before scale for cool effect of freeze in the air
+		const bool bSimulated = Component->IsSimulatingPhysics();
+		Component->SetSimulatePhysics(false);
+		Component->SetRelativeScale3D(NewScale);
+		NotifyScaleCommitted(Component, NewScale);
+		// turn physics back on to recalculate collisions in physics step, only if it was on
+		Component->SetSimulatePhysics(bSimulated);
+		INC_DWORD_STAT(STAT_BeamCollisionCommits);
+		INC_DWORD_STAT(STAT_BeamRebuildsWithoutPreview);
+		INC_DWORD_STAT(STAT_BeamRebuilds);
+		return;
 	}
-	// If we hit something in the back 1.the cube could be stucked or 2.we are moving too fast
-	else
+
+	if (PreviewTarget.Get() != Component)
 	{
-		// Launch disconnection timer, if we hit the cube again the timer will be cleared
-		if (!StuckTimerHandle.IsValid())
+		EndScalePreview();
+
+		// Render only copy of the mesh, the original keeps the collision.
+		// Created once and moved from target to target
+		if (PreviewComponent == nullptr)
 		{
-			GetWorld()->GetTimerManager().SetTimer(StuckTimerHandle, this, &UBeamComponent::TryReleaseObject, DisconnectionTime, false);
+			PreviewComponent = NewObject<UStaticMeshComponent>(GetOwner(), NAME_None, RF_Transient);
+			PreviewComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			PreviewComponent->SetGenerateOverlapEvents(false);
+			PreviewComponent->RegisterComponent();
 		}
+		PreviewComponent->SetStaticMesh(sourceMesh->GetStaticMesh());
+		for (int32 i = 0; i < sourceMesh->GetNumMaterials(); ++i)
+		{
+			PreviewComponent->SetMaterial(i, sourceMesh->GetMaterial(i));
+		}
+		PreviewComponent->AttachToComponent(sourceMesh, FAttachmentTransformRules::SnapToTargetIncludingScale);
+		PreviewComponent->SetVisibility(true);
+
+		// turn off physics for cool effect of freeze in the air while scaling
+		bPreviewTargetSimulated = sourceMesh->IsSimulatingPhysics();
+		sourceMesh->SetSimulatePhysics(false);
+		sourceMesh->SetVisibility(false, false);
+
+		PreviewTarget = sourceMesh;
+		CommittedScale = sourceMesh->GetRelativeScale3D();
+		LastCommitTime = GetWorld()->GetTimeSeconds();
+	}
+
+	PreviewScale = NewScale;
+
+	// Commit to the physics body every ScaleCommitInterval, sooner if the collision is too far from the mesh.
+	// Slow scaling still reaches the collision and the clients, fast scaling stays within the budget
+	const UStaticMesh* mesh = sourceMesh->GetStaticMesh();
+	const float meshExtent = (mesh != nullptr) ? mesh->GetBounds().BoxExtent.GetAbsMax() : Component->Bounds.BoxExtent.GetAbsMax();
+	const float extentChange = (PreviewScale - CommittedScale).GetAbsMax() * meshExtent;
+	const BeamCore::FBeamScaleCommitParams commitParams = { ScaleCommitInterval, ScaleCommitDistance };
+	if (BeamCore::ShouldCommitScale(commitParams, GetWorld()->GetTimeSeconds() - LastCommitTime, extentChange))
+	{
+		CommitScale();
 	}
+
+	// Child inherits the committed scale, preview only adds the difference
+	PreviewComponent->SetRelativeScale3D(PreviewScale / CommittedScale);
+	INC_DWORD_STAT(STAT_BeamScalePreviewFrames);
+	// Without the preview every scaling frame rebuilds the collision
+	INC_DWORD_STAT(STAT_BeamRebuildsWithoutPreview);
+}
+
+void UBeamComponent::CommitScale()
+{
+	UPrimitiveComponent* target = PreviewTarget.Get();
+	if (target != nullptr && !PreviewScale.Equals(CommittedScale))
+	{
+		target->SetRelativeScale3D(PreviewScale);
+		NotifyScaleCommitted(target, PreviewScale);
+		CommittedScale = PreviewScale;
+		LastCommitTime = GetWorld()->GetTimeSeconds();
+		INC_DWORD_STAT(STAT_BeamCollisionCommits);
+		INC_DWORD_STAT(STAT_BeamRebuilds);
+	}
+}
+
+void UBeamComponent::EndScalePreview()
+{
+	LLM_SCOPED_TAG_WITH_STAT(STAT_BeamScalingLLM, ELLMTracker::Default);
+	UPrimitiveComponent* target = PreviewTarget.Get();
+	if (target != nullptr)
+	{
+		CommitScale();
+		target->SetVisibility(true, false);
+		// turn physics back on to recalculate collisions in physics step, only if it was on
+		target->SetSimulatePhysics(bPreviewTargetSimulated);
+	}
+
+	// Kept around hidden for the next target
+	if (PreviewComponent != nullptr)
+	{
+		PreviewComponent->SetVisibility(false);
+		PreviewComponent->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+	}
+	PreviewTarget.Reset();
 }
 
 void UBeamComponent::TryReleaseObject()
 {
 	if (PhysicsHandleComponent->IsActive())
 	{
+		const UPrimitiveComponent* grabbed = PhysicsHandleComponent->GetGrabbedComponent();
+		if (grabbed != nullptr)
+		{
+			FBeamEventLog::Record(EBeamEventType::Release, GetOwner(), grabbed->GetOwner(), grabbed->GetComponentLocation(), 0.0f, BeamState);
+		}
 		PhysicsHandleComponent->ReleaseComponent();
 		PhysicsHandleComponent->SetActive(false);	
 	}
+	StopStuckTracking();
 }
 
-void UBeamComponent::BeamEffects(const FVector start, const FVector end)
+void UBeamComponent::StartStuckTracking(UPrimitiveComponent* Component)
 {
-	// Trail VFX and sound effects should be here
-	DrawDebugLine(GetWorld(), start, end, GetBeamColor(BeamState), false, -1.0f, 0, BeamThickness);	// development only
+	StopStuckTracking();
+
+	// Contacts only reach us with hit notifies on, keep the setting of the component to restore it
+	StuckTrackedComponent = Component;
+	bTrackedNotifiedCollision = Component->BodyInstance.bNotifyRigidBodyCollision;
+	Component->SetNotifyRigidBodyCollision(true);
+	Component->OnComponentHit.AddDynamic(this, &UBeamComponent::OnGrabbedHit);
 }
 
-void UBeamComponent::UpdateBeamState(BeamMode NewMode)
+void UBeamComponent::StopStuckTracking()
 {
-	if (BeamState == BeamMode::OFF)
+	UPrimitiveComponent* component = StuckTrackedComponent.Get();
+	if (component != nullptr)
 	{
-		BeamState = NewMode;
+		component->OnComponentHit.RemoveDynamic(this, &UBeamComponent::OnGrabbedHit);
+		component->SetNotifyRigidBodyCollision(bTrackedNotifiedCollision);
 	}
-	else if (BeamState == BeamMode::GRAB)
+	StuckTrackedComponent.Reset();
+	StuckDetector.Reset();
+	RecentContacts.Reset();
+}
+
+void UBeamComponent::OnGrabbedHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
+{
+	// Bumping into the player holding it never blocks
+	if (OtherActor == GetOwner())
 	{
-		if (NewMode == BeamMode::DIMINUATOR)
-		{
-			BeamState = BeamMode::AUGMENTATOR;
-		}
-		else if (NewMode == BeamMode::AUGMENTATOR)
-		{
-			BeamState = BeamMode::DIMINUATOR;
-		}
+		return;
 	}
-	else
+
+	RecentContacts.Add(BeamCoreBridge::ToCore(Hit.ImpactNormal), GetWorld()->GetTimeSeconds());
+}
+
+void UBeamComponent::UpdateStuckDetection(float DeltaTime)
+{
+	const UPrimitiveComponent* grabbed = PhysicsHandleComponent->GetGrabbedComponent();
+
+	FVector targetLocation;
+	FRotator targetRotation;
+	PhysicsHandleComponent->GetTargetLocationAndRotation(targetLocation, targetRotation);
+	const FVector trackingError = targetLocation - grabbed->GetComponentLocation();
+
+	BeamCore::FBeamStuckParams params;
+	params.MaxTrackingError = StuckTrackingError;
+	params.ReleaseTime = DisconnectionTime;
+	params.MinBlockingAngleCos = BeamCoreBridge::StuckBlockingAngleCos;
+
+	// The contact most against the pull is the one holding the component back
+	BeamCore::FBeamVector contactNormal;
+	const bool bRecentContact = RecentContacts.GetMostOpposing(BeamCoreBridge::ToCore(trackingError), GetWorld()->GetTimeSeconds(), BeamCoreBridge::StuckContactTolerance, contactNormal);
+	switch (StuckDetector.Update(params, DeltaTime, BeamCoreBridge::ToCore(trackingError), contactNormal, bRecentContact))
 	{
-		if (BeamState != NewMode)
-		{
-			BeamState = BeamMode::GRAB;
-		}
-		else
-		{
-			BeamState = BeamMode::OFF;
-		}
+	case BeamCore::EBeamStuckAction::Stuck:
+		FBeamEventLog::Record(EBeamEventType::StuckTimerStart, GetOwner(), grabbed->GetOwner(), grabbed->GetComponentLocation(), DisconnectionTime, BeamState);
+		break;
+
+	// The object could not follow the beam in time, drop it
+	case BeamCore::EBeamStuckAction::Release:
+		FBeamEventLog::Record(EBeamEventType::StuckTimerFire, GetOwner(), grabbed->GetOwner(), grabbed->GetComponentLocation(), 0.0f, BeamState);
+		TryReleaseObject();
+		break;
+
+	default:
+		break;
 	}
 }
 
-bool UBeamComponent::CheckScalingConditions(FVector newScale3D)
+void UBeamComponent::BeamEffects(const FTransform& Correction)
 {
-	return ((newScale3D.Size() > HitComponent->GetRelativeScale3D().Size() && !CheckScaleCollisions(HitComponent))
-		|| newScale3D.Size() < HitComponent->GetRelativeScale3D().Size() && newScale3D.Size() > MinSize);
+	// Trail VFX and sound effects should be here
+	float travelled = 0.0f;
+	for (int32 i = 0; i < BeamPath.Segments.Num() && travelled < BeamLength; ++i)
+	{
+		const FBeamSegment& segment = BeamPath.Segments[i];
+		const bool bLast = (i == BeamPath.Segments.Num() - 1);
+		const float segmentLength = bLast ? (BeamLength - travelled) : FMath::Min(segment.GetLength(), BeamLength - travelled);
+		const FVector end = segment.Start + (segment.End - segment.Start).GetSafeNormal() * segmentLength;
+		DrawDebugLine(GetWorld(), Correction.TransformPosition(segment.Start), Correction.TransformPosition(end), GetBeamColor(BeamState), false, -1.0f, 0, BeamThickness);	// development only
+		travelled += segmentLength;
+	}
+}
+
+void UBeamComponent::UpdateBeamState(BeamMode NewMode)
+{
+	const BeamMode previousState = BeamState;
+	BeamState = BeamCoreBridge::FromCore(BeamCore::NextBeamMode(BeamCoreBridge::ToCore(BeamState), BeamCoreBridge::ToCore(NewMode)));
+
+	const UPrimitiveComponent* grabbed = PhysicsHandleComponent->GetGrabbedComponent();
+	FBeamEventLog::Record(EBeamEventType::StateChange, GetOwner(), (grabbed != nullptr) ? grabbed->GetOwner() : nullptr, Start, 0.0f, BeamState, previousState);
+}
+
+bool UBeamComponent::CheckScalingConditions(FVector currentScale3D, FVector newScale3D)
+{
+	auto isBlocked = [this]() { return CheckScaleCollisions(HitComponent); };
+
+	UObject* scalable = GetScalable(HitComponent);
+	if (scalable != nullptr)
+	{
+		const BeamCore::FBeamScaleLimits limits = { IScalable::Execute_GetMinScale(scalable), IScalable::Execute_GetMaxScale(scalable), true };
+		return BeamCore::CanScale(limits, currentScale3D.GetAbsMax(), newScale3D.GetAbsMax(), isBlocked);
+	}
+
+	const BeamCore::FBeamScaleLimits limits = { MinSize, MAX_flt, false };
+	return BeamCore::CanScale(limits, currentScale3D.Size(), newScale3D.Size(), isBlocked);
+}
+
+UObject* UBeamComponent::GetScalable(UPrimitiveComponent* Component)
+{
+	if (ScalableComponent.Get() != Component)
+	{
+		ScalableComponent = Component;
+		Scalable = IScalable::Find(Component);
+	}
+	return Scalable.Get();
+}
+
+bool UBeamComponent::IsScalable(UPrimitiveComponent* Component)
+{
+	// Channel first, it is just a field read
+	return Component->GetCollisionObjectType() == ECC_Scalable
+		|| Component->IsSimulatingPhysics()
+		|| GetScalable(Component) != nullptr;
+}
+
+void UBeamComponent::NotifyScaleCommitted(UPrimitiveComponent* Component, const FVector& NewScale)
+{
+	UObject* scalable = GetScalable(Component);
+	if (scalable != nullptr)
+	{
+		IScalable::Execute_OnScaleCommitted(scalable, Component, NewScale);
+	}
 }
 
 FColor UBeamComponent::GetBeamColor(BeamMode Mode)
@@ -258,78 +896,108 @@ FColor UBeamComponent::GetBeamColor(BeamMode Mode)
 
 float UBeamComponent::GetBeamScale(BeamMode Mode)
 {
-	switch (Mode)
-	{
-	case BeamMode::DIMINUATOR:
-		return -BeamScaleSpeed;
-		break;
-
-	case BeamMode::AUGMENTATOR:
-		return BeamScaleSpeed;
-		break;
-	}
-	return 0.0f;
+	return BeamCore::GetBeamScaleRate(BeamCoreBridge::ToCore(Mode), BeamScaleSpeed);
 }
 
-bool UBeamComponent::IsBeamActive()
+bool UBeamComponent::IsBeamActive() const
 {
 	return BeamState != BeamMode::OFF;
 }
 
+bool UBeamComponent::IsGrabbing() const
+{
+	return PhysicsHandleComponent->IsActive() && PhysicsHandleComponent->GetGrabbedComponent() != nullptr;
+}
+
 bool UBeamComponent::CheckScaleCollisions(UPrimitiveComponent* component)
 {
-	bool bUp1 = CheckVertexCollisions(component, FVector::UpVector, FVector::UpVector + FVector::LeftVector + FVector::ForwardVector);
-	bool bUp2 = CheckVertexCollisions(component, FVector::UpVector, FVector::UpVector + FVector::LeftVector + FVector::BackwardVector);
-	bool bUp3 = CheckVertexCollisions(component, FVector::UpVector, FVector::UpVector + FVector::RightVector + FVector::ForwardVector);
-	bool bUp4 = CheckVertexCollisions(component, FVector::UpVector, FVector::UpVector + FVector::RightVector + FVector::BackwardVector);
-	bool bUp = bUp1 || bUp2 || bUp3 || bUp4;
-
-	bool bDown1 = CheckVertexCollisions(component, FVector::DownVector, FVector::DownVector + FVector::LeftVector + FVector::ForwardVector);
-	bool bDown2 = CheckVertexCollisions(component, FVector::DownVector, FVector::DownVector + FVector::LeftVector + FVector::BackwardVector);
-	bool bDown3 = CheckVertexCollisions(component, FVector::DownVector, FVector::DownVector + FVector::RightVector + FVector::ForwardVector);
-	bool bDown4 = CheckVertexCollisions(component, FVector::DownVector, FVector::DownVector + FVector::RightVector + FVector::BackwardVector);
-	bool bDown = bDown1 || bDown2 || bDown3 || bDown4;
-
-	bool bLeft1 = CheckVertexCollisions(component, FVector::LeftVector, FVector::LeftVector + FVector::UpVector + FVector::ForwardVector);
-	bool bLeft2 = CheckVertexCollisions(component, FVector::LeftVector, FVector::LeftVector + FVector::UpVector + FVector::BackwardVector);
-	bool bLeft3 = CheckVertexCollisions(component, FVector::LeftVector, FVector::LeftVector + FVector::DownVector + FVector::ForwardVector);
-	bool bLeft4 = CheckVertexCollisions(component, FVector::LeftVector, FVector::LeftVector + FVector::DownVector + FVector::BackwardVector);
-	bool bLeft = bLeft1 || bLeft2 || bLeft3 || bLeft4;
-
-	bool bRight1 = CheckVertexCollisions(component, FVector::RightVector, FVector::RightVector + FVector::UpVector + FVector::ForwardVector);
-	bool bRight2 = CheckVertexCollisions(component, FVector::RightVector, FVector::RightVector + FVector::UpVector + FVector::BackwardVector);
-	bool bRight3 = CheckVertexCollisions(component, FVector::RightVector, FVector::RightVector + FVector::DownVector + FVector::ForwardVector);
-	bool bRight4 = CheckVertexCollisions(component, FVector::RightVector, FVector::RightVector + FVector::DownVector + FVector::BackwardVector);
-	bool bRight = bRight1 || bRight2 || bRight3 || bRight4;
-
-	bool bForward1 = CheckVertexCollisions(component, FVector::ForwardVector, FVector::ForwardVector + FVector::UpVector + FVector::LeftVector);
-	bool bForward2 = CheckVertexCollisions(component, FVector::ForwardVector, FVector::ForwardVector + FVector::UpVector + FVector::RightVector);
-	bool bForward3 = CheckVertexCollisions(component, FVector::ForwardVector, FVector::ForwardVector + FVector::DownVector + FVector::LeftVector);
-	bool bForward4 = CheckVertexCollisions(component, FVector::ForwardVector, FVector::ForwardVector + FVector::DownVector + FVector::RightVector);
-	bool bForward = bForward1 || bForward2 || bForward3 || bForward4;
-
-	bool bBackward1 = CheckVertexCollisions(component, FVector::BackwardVector, FVector::BackwardVector + FVector::UpVector + FVector::LeftVector);
-	bool bBackward2 = CheckVertexCollisions(component, FVector::BackwardVector, FVector::BackwardVector + FVector::UpVector + FVector::RightVector);
-	bool bBackward3 = CheckVertexCollisions(component, FVector::BackwardVector, FVector::BackwardVector + FVector::DownVector + FVector::LeftVector);
-	bool bBackward4 = CheckVertexCollisions(component, FVector::BackwardVector, FVector::BackwardVector + FVector::DownVector + FVector::RightVector);
-	bool bBackward = bBackward1 || bBackward2 || bBackward3 || bBackward4;
-
-	return (bUp && bDown) || (bLeft && bRight) || (bForward && bBackward);
-}
-
-bool UBeamComponent::CheckVertexCollisions(UPrimitiveComponent* component, const FVector direction, const FVector vertexDirection)
-{
-	FHitResult outHit;
-	float cubeHalfLength = component->Bounds.SphereRadius / 2.0f;	// cube width
-	float size = cubeHalfLength / 4;	// ray size
-	FCollisionQueryParams params;
-	params.AddIgnoredActor(component->GetOwner());
-	//const FName TraceTag("TraceTag");
-	//GetWorld()->DebugDrawTraceTag = TraceTag;
-	//params.TraceTag = TraceTag;
-
-	// Calculate vertex position by adding cube half length to the center in vertex direction.
-	FVector start = component->GetComponentLocation() + component->GetComponentRotation().RotateVector(vertexDirection * cubeHalfLength);
-	FVector end = start + component->GetComponentRotation().RotateVector(direction) * size;
-	return GetWorld()->LineTraceSingleByChannel(outHit, start, end, ECollisionChannel::ECC_WorldStatic, params);
+	LLM_SCOPED_TAG_WITH_STAT(STAT_BeamScalingLLM, ELLMTracker::Default);
+
+	// Full probe set whatever the significance, the result decides the real scale
+	UObject* scalable = GetScalable(component);
+	const bool bSphere = scalable != nullptr && IScalable::Execute_GetClearanceShape(scalable) == EScalableClearanceShape::Sphere;
+	const BeamCore::EBeamClearanceShape shape = bSphere ? BeamCore::EBeamClearanceShape::Sphere : BeamCore::EBeamClearanceShape::Box;
+	const int32 numProbes = BeamCore::GetClearanceProbeCount(shape);
+
+	// Allocated once for the biggest probe set, smaller sets use the first ones
+	if (ClearanceQueries.Num() != BeamCore::BeamClearanceMaxProbes)
+	{
+		ClearanceQueries.Reset(BeamCore::BeamClearanceMaxProbes);
+		for (int32 i = 0; i < BeamCore::BeamClearanceMaxProbes; ++i)
+		{
+			ClearanceQueries.Add(MakeShared<FBeamQuery>());
+		}
+	}
+
+	// Results shot for another component, or for another probe set, mean nothing here
+	if (ClearanceTarget.Get() != component || bClearanceSphere != bSphere)
+	{
+		ClearanceTarget = component;
+		bClearanceSphere = bSphere;
+		for (const TSharedRef<FBeamQuery>& query : ClearanceQueries)
+		{
+			query->Invalidate();
+		}
+	}
+
+	// Bounds follow the collision scale, validate against the preview when it is bigger
+	const float previewRatio = FMath::Max(1.0f, GetVisualScale(component).GetAbsMax() / FMath::Max(component->GetRelativeScale3D().GetAbsMax(), KINDA_SMALL_NUMBER));
+
+	BeamCore::FBeamClearanceTarget target;
+	target.Center = BeamCoreBridge::ToCore(component->GetComponentLocation());
+	target.Rotation = BeamCoreBridge::ToCore(component->GetComponentQuat());
+	target.HalfLength = previewRatio * component->Bounds.SphereRadius / 2.0f;
+	target.Shape = shape;
+	// Results age in frames, a slower tick must not make all of them stale
+	const float tickInterval = GetComponentTickInterval();
+	target.MaxAge = MaxClearanceAge + ((tickInterval > 0.0f) ? FMath::CeilToInt(tickInterval / FMath::Max(GetWorld()->GetDeltaSeconds(), KINDA_SMALL_NUMBER)) : 0);
+
+	// Probe only the faces with a body near them, nothing near means open space around
+	uint8 faceMask = BeamCore::BeamClearanceAllFaces;
+	if (bProximityShell)
+	{
+		if (ProximityShell == nullptr)
+		{
+			ProximityShell = NewObject<UBeamProximityShell>(GetOwner(), NAME_None, RF_Transient);
+			ProximityShell->RegisterComponent();
+		}
+		ProximityShell->Track(component, BeamCore::GetClearanceReach(shape) * target.HalfLength);
+
+		// Moving bodies from the overlap events, level geometry from the static query
+		faceMask = 0;
+		for (const TArray<TWeakObjectPtr<UPrimitiveComponent>>* bodies : { &ProximityShell->GetNearbyBodies(), &ProximityShell->GetStaticBodies() })
+		{
+			for (const TWeakObjectPtr<UPrimitiveComponent>& body : *bodies)
+			{
+				if (body.IsValid())
+				{
+					faceMask |= BeamCore::GetOccupiedFaces(target, BeamCoreBridge::ToCore(body->Bounds.Origin), BeamCoreBridge::ToCore(body->Bounds.BoxExtent));
+				}
+			}
+		}
+	}
+
+	BeamClearanceStats::Record(faceMask == 0);
+	if (faceMask == 0)
+	{
+		return false;
+	}
+
+	BeamCoreBridge::FScheduledProbeQueries probeQueries(ClearanceQueries, component->GetOwner());
+	const bool bBlocked = BeamCore::CheckClearance(probeQueries, target, faceMask);
+
+	UBeamQuerySubsystem* scheduler = UBeamQuerySubsystem::Get(GetWorld());
+	if (scheduler != nullptr)
+	{
+		const int32 probesPerFace = numProbes / BeamCore::BeamClearanceFaces;
+		for (int32 i = 0; i < numProbes; ++i)
+		{
+			if ((faceMask & (1 << (i / probesPerFace))) != 0)
+			{
+				scheduler->Enqueue(ClearanceQueries[i]);
+			}
+		}
+	}
+
+	return bBlocked;
 }
@@ -0,0 +1,258 @@
+// Tequila Works test
+#include "Components/ScalableComponent.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Net/UnrealNetwork.h"
+#include "DiminuatorTypes.h"
+#include "Stress/ServerLoadReport.h"
+
+UScalableComponent::UScalableComponent()
+{
+	// Server only, checks for dormancy and updates the net priority while awake
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickInterval = 0.25f;
+	SetIsReplicatedByDefault(true);
+
+	MinScale = 0.2f;
+	MaxScale = 5.0f;
+	MassPolicy = EScalableMassPolicy::Volume;
+	ClearanceShape = EScalableClearanceShape::Box;
+	bRegisterObjectChannel = true;
+	bManageNetDormancy = true;
+	DormancyDelay = 2.0f;
+	BaseNetPriority = 1.0f;
+	BeamPriorityBoost = 3.0f;
+	BeamPriorityDistance = 2000.0f;
+	ScalePriorityBoost = 2.0f;
+	PriorityFadeTime = 1.0f;
+	ScaleInterpTime = 0.1f;
+	BaseMass = 0.0f;
+	BaseScale = 1.0f;
+
+	ReplicatedScale = FVector::OneVector;
+	InterpStartScale = FVector::OneVector;
+	InterpAlpha = 1.0f;
+	LastBeamedTime = -BIG_NUMBER;
+	LastBeamDistance = 0.0f;
+	LastScaleTime = -BIG_NUMBER;
+	LastWakeTime = -BIG_NUMBER;
+	bDormancyManaged = false;
+	bDormant = false;
+}
+
+void UScalableComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UScalableComponent, ReplicatedScale);
+}
+
+void UScalableComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	UPrimitiveComponent* primitive = Cast<UPrimitiveComponent>(GetOwner()->GetRootComponent());
+	if (primitive == nullptr)
+	{
+		return;
+	}
+
+	if (bRegisterObjectChannel)
+	{
+		primitive->SetCollisionObjectType(ECC_Scalable);
+	}
+
+	BaseScale = FMath::Max(primitive->GetRelativeScale3D().GetAbsMax(), KINDA_SMALL_NUMBER);
+	BaseMass = primitive->IsSimulatingPhysics() ? primitive->GetMass() : 0.0f;
+
+	AActor* owner = GetOwner();
+	if (!bManageNetDormancy || !owner->HasAuthority() || GetNetMode() == NM_Standalone)
+	{
+		return;
+	}
+
+	owner->SetReplicates(true);
+	owner->SetReplicateMovement(true);
+	owner->NetPriority = BaseNetPriority;
+	ReplicatedScale = primitive->GetRelativeScale3D();
+
+	// Physics contacts, pushes and impulses wake the body, wake events are read when the body is created
+	if (!primitive->BodyInstance.bGenerateWakeEvents)
+	{
+		primitive->BodyInstance.bGenerateWakeEvents = true;
+		primitive->RecreatePhysicsState();
+	}
+	primitive->OnComponentWake.AddDynamic(this, &UScalableComponent::OnRootWake);
+
+	// Starts awake, the tick sends it to sleep once the body settles
+	bDormancyManaged = true;
+	UServerLoadReport::ScalableObjects++;
+	UServerLoadReport::AwakeScalableObjects++;
+	LastWakeTime = GetWorld()->GetTimeSeconds();
+	SetComponentTickEnabled(true);
+}
+
+void UScalableComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bDormancyManaged)
+	{
+		UServerLoadReport::ScalableObjects--;
+		if (!bDormant)
+		{
+			UServerLoadReport::AwakeScalableObjects--;
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UScalableComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// Clients only tick while blending the scale
+	if (!GetOwner()->HasAuthority())
+	{
+		if (!UpdateScaleInterp(DeltaTime))
+		{
+			SetComponentTickEnabled(false);
+		}
+		return;
+	}
+
+	const float now = GetWorld()->GetTimeSeconds();
+	UpdateNetPriority(now);
+
+	// Frozen while scaled or not simulating at all counts as asleep, the beam keeps it awake instead
+	const UPrimitiveComponent* primitive = Cast<UPrimitiveComponent>(GetOwner()->GetRootComponent());
+	const bool bAsleep = primitive == nullptr || !primitive->IsSimulatingPhysics() || !primitive->RigidBodyIsAwake();
+	const float lastActiveTime = FMath::Max3(LastBeamedTime, LastScaleTime, LastWakeTime);
+	if (bAsleep && now - lastActiveTime >= DormancyDelay)
+	{
+		GoDormant();
+	}
+}
+
+void UScalableComponent::NotifyBeamed(const FVector& BeamStart)
+{
+	if (!GetOwner()->HasAuthority())
+	{
+		return;
+	}
+
+	LastBeamedTime = GetWorld()->GetTimeSeconds();
+	LastBeamDistance = FVector::Dist(BeamStart, GetOwner()->GetActorLocation());
+	WakeUp();
+}
+
+void UScalableComponent::WakeUp()
+{
+	if (!GetOwner()->HasAuthority())
+	{
+		return;
+	}
+
+	LastWakeTime = GetWorld()->GetTimeSeconds();
+	if (bDormant)
+	{
+		bDormant = false;
+		UServerLoadReport::AwakeScalableObjects++;
+		GetOwner()->SetNetDormancy(DORM_Awake);
+		UpdateNetPriority(LastWakeTime);
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UScalableComponent::GoDormant()
+{
+	// Last changes still go out before the channel closes
+	bDormant = true;
+	UServerLoadReport::AwakeScalableObjects--;
+	GetOwner()->NetPriority = BaseNetPriority;
+	GetOwner()->SetNetDormancy(DORM_DormantAll);
+	SetComponentTickEnabled(false);
+}
+
+void UScalableComponent::UpdateNetPriority(float Now)
+{
+	// Both boosts fade out linearly, the beam one also with the distance to the beam start
+	const float beamFade = 1.0f - FMath::Clamp((Now - LastBeamedTime) / PriorityFadeTime, 0.0f, 1.0f);
+	const float scaleFade = 1.0f - FMath::Clamp((Now - LastScaleTime) / PriorityFadeTime, 0.0f, 1.0f);
+	const float beamProximity = 1.0f - FMath::Clamp(LastBeamDistance / BeamPriorityDistance, 0.0f, 1.0f);
+
+	GetOwner()->NetPriority = BaseNetPriority * (1.0f + BeamPriorityBoost * beamProximity * beamFade + ScalePriorityBoost * scaleFade);
+}
+
+void UScalableComponent::OnRootWake(UPrimitiveComponent* WakingComponent, FName BoneName)
+{
+	WakeUp();
+}
+
+void UScalableComponent::OnRep_ReplicatedScale()
+{
+	UPrimitiveComponent* primitive = Cast<UPrimitiveComponent>(GetOwner()->GetRootComponent());
+	if (primitive == nullptr || primitive->GetRelativeScale3D().Equals(ReplicatedScale))
+	{
+		return;
+	}
+
+	// Commits arrive a few per second, blend from wherever the last blend got to
+	InterpStartScale = primitive->GetRelativeScale3D();
+	InterpAlpha = 0.0f;
+	if (ScaleInterpTime <= 0.0f || !HasBegunPlay())
+	{
+		UpdateScaleInterp(ScaleInterpTime);
+		return;
+	}
+
+	// Every frame while blending, the server tick interval is for dormancy checks
+	SetComponentTickInterval(0.0f);
+	SetComponentTickEnabled(true);
+}
+
+bool UScalableComponent::UpdateScaleInterp(float DeltaTime)
+{
+	UPrimitiveComponent* primitive = Cast<UPrimitiveComponent>(GetOwner()->GetRootComponent());
+	if (primitive == nullptr || InterpAlpha >= 1.0f)
+	{
+		return false;
+	}
+
+	InterpAlpha = (ScaleInterpTime > 0.0f) ? FMath::Min(InterpAlpha + DeltaTime / ScaleInterpTime, 1.0f) : 1.0f;
+	primitive->SetRelativeScale3D(FMath::Lerp(InterpStartScale, FVector(ReplicatedScale), InterpAlpha));
+	return InterpAlpha < 1.0f;
+}
+
+void UScalableComponent::OnScaleCommitted_Implementation(UPrimitiveComponent* Component, FVector NewScale)
+{
+	if (Component != nullptr && GetOwner()->HasAuthority())
+	{
+		ReplicatedScale = NewScale;
+		LastScaleTime = GetWorld()->GetTimeSeconds();
+		WakeUp();
+	}
+
+	if (Component == nullptr || BaseMass <= 0.0f)
+	{
+		return;
+	}
+
+	switch (MassPolicy)
+	{
+	case EScalableMassPolicy::Volume:
+		// Body mass is computed from the scaled shape
+		Component->SetMassOverrideInKg(NAME_None, BaseMass, false);
+		break;
+
+	case EScalableMassPolicy::Linear:
+		Component->SetMassOverrideInKg(NAME_None, BaseMass * NewScale.GetAbsMax() / BaseScale, true);
+		break;
+
+	case EScalableMassPolicy::Constant:
+		Component->SetMassOverrideInKg(NAME_None, BaseMass, true);
+		break;
+	}
+}
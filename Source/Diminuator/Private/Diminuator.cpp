@@ -2,6 +2,27 @@
 
 #include "Diminuator.h"
 #include "Modules/ModuleManager.h"
+#include "Beam/BeamEventLog.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Diminuator, "Diminuator" );
- 
\ No newline at end of file
+DEFINE_LOG_CATEGORY(LogBeam);
+
+DEFINE_STAT(STAT_BeamLLM);
+DEFINE_STAT(STAT_BeamScalingLLM);
+DEFINE_STAT(STAT_ProjectileLLM);
+
+class FDiminuatorModule : public FDefaultGameModuleImpl
+{
+public:
+
+	virtual void StartupModule() override
+	{
+		FBeamEventLog::Startup();
+	}
+
+	virtual void ShutdownModule() override
+	{
+		FBeamEventLog::Shutdown();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FDiminuatorModule, Diminuator, "Diminuator" );
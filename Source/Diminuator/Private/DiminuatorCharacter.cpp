@@ -2,6 +2,7 @@
 
 #include "DiminuatorCharacter.h"
 #include "DiminuatorProjectile.h"
+#include "Diminuator.h"
 #include "Animation/AnimInstance.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
@@ -13,6 +14,8 @@
 #include "XRMotionControllerBase.h" // for FXRMotionControllerBase::RightHandSourceId
 
 #include "Components/BeamComponent.h"
+#include "Components/BeamBotComponent.h"
+#include "Rooms/RoomStreamingManager.h"
 #include "DiminuatorTypes.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogFPChar, Warning, All);
@@ -87,6 +90,22 @@ ADiminuatorCharacter::ADiminuatorCharacter()
 	BeamComponent = CreateDefaultSubobject<UBeamComponent>(TEXT("BeamComponent"));
 }
 
+void ADiminuatorCharacter::GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const
+{
+	if (!ProjectileClass.IsNull())
+	{
+		OutAssets.Add(ProjectileClass.ToSoftObjectPath());
+	}
+	if (!FireSound.IsNull())
+	{
+		OutAssets.Add(FireSound.ToSoftObjectPath());
+	}
+	if (!FireAnimation.IsNull())
+	{
+		OutAssets.Add(FireAnimation.ToSoftObjectPath());
+	}
+}
+
 void ADiminuatorCharacter::BeginPlay()
 {
 	// Call the base class  
@@ -108,6 +127,18 @@ void ADiminuatorCharacter::BeginPlay()
 	}
 }
 
+void ADiminuatorCharacter::PawnClientRestart()
+{
+	Super::PawnClientRestart();
+
+	// Headless load test clients play by themselves
+	if (FParse::Param(FCommandLine::Get(), TEXT("BeamBot")) && FindComponentByClass<UBeamBotComponent>() == nullptr)
+	{
+		UBeamBotComponent* bot = NewObject<UBeamBotComponent>(this, TEXT("BeamBot"));
+		bot->RegisterComponent();
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Input
 
@@ -144,47 +175,156 @@ void ADiminuatorCharacter::SetupPlayerInputComponent(class UInputComponent* Play
 
 void ADiminuatorCharacter::OnStartDiminuator()
 {
-	BeamComponent->OnStartFire(BeamMode::DIMINUATOR);
+	StartBeam(BeamMode::DIMINUATOR);
 }
 
 void ADiminuatorCharacter::OnStopDiminuator()
 {
-	BeamComponent->OnStopFire(BeamMode::DIMINUATOR);
+	StopBeam(BeamMode::DIMINUATOR);
 }
 
 void ADiminuatorCharacter::OnStartAugmentator()
 {
-	BeamComponent->OnStartFire(BeamMode::AUGMENTATOR);
+	StartBeam(BeamMode::AUGMENTATOR);
 }
 
 void ADiminuatorCharacter::OnStopAugmentator()
 {
-	BeamComponent->OnStopFire(BeamMode::AUGMENTATOR);
+	StopBeam(BeamMode::AUGMENTATOR);
+}
+
+void ADiminuatorCharacter::StartBeam(BeamMode Mode)
+{
+	// Beam grabs and scales replicated physics objects, only the server runs it.
+	// The mode is predicted here so the beam is drawn right away
+	BeamComponent->OnStartFire(Mode);
+	if (!HasAuthority())
+	{
+		ServerStartBeam(Mode);
+	}
+}
+
+void ADiminuatorCharacter::StopBeam(BeamMode Mode)
+{
+	BeamComponent->OnStopFire(Mode);
+	if (!HasAuthority())
+	{
+		ServerStopBeam(Mode);
+	}
+}
+
+void ADiminuatorCharacter::ServerStartBeam_Implementation(TEnumAsByte<BeamMode> Mode)
+{
+	BeamComponent->OnStartFire(Mode);
+}
+
+void ADiminuatorCharacter::ServerStopBeam_Implementation(TEnumAsByte<BeamMode> Mode)
+{
+	BeamComponent->OnStopFire(Mode);
+}
+
+void ADiminuatorCharacter::Fire()
+{
+	// Load test bots only, players have no fire input.
+	// Sound and animation are local, the projectile replicates
+	if (!IsNetMode(NM_DedicatedServer))
+	{
+		FireEffects();
+	}
+
+	if (HasAuthority())
+	{
+		SpawnProjectile();
+	}
+	else
+	{
+		ServerFire();
+	}
+}
+
+void ADiminuatorCharacter::ServerFire_Implementation()
+{
+	SpawnProjectile();
+}
+
+void ADiminuatorCharacter::SpawnProjectile()
+{
+	// Not preloaded yet, skip the shot rather than hitch
+	UClass* projectileClass = ProjectileClass.Get();
+	UWorld* const world = GetWorld();
+	if (projectileClass == nullptr || world == nullptr)
+	{
+		return;
+	}
+
+	LLM_SCOPED_TAG_WITH_STAT(STAT_ProjectileLLM, ELLMTracker::Default);
+	USceneComponent* muzzle = bUsingMotionControllers ? VR_MuzzleLocation : FP_MuzzleLocation;
+	const FRotator spawnRotation = bUsingMotionControllers ? muzzle->GetComponentRotation() : GetControlRotation();
+	const FVector spawnLocation = muzzle->GetComponentLocation();
+
+	FActorSpawnParameters spawnParams;
+	spawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
+	spawnParams.Owner = this;
+	spawnParams.Instigator = this;
+	world->SpawnActor<ADiminuatorProjectile>(projectileClass, spawnLocation, spawnRotation, spawnParams);
 }
 
 void ADiminuatorCharacter::FireEffects()
 {
-	// try and play the sound if specified
-	if (FireSound != nullptr)
+	// try and play the sound if specified and already loaded
+	USoundBase* fireSound = FireSound.Get();
+	if (fireSound != nullptr)
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, FireSound, GetActorLocation());
+		UGameplayStatics::PlaySoundAtLocation(this, fireSound, GetActorLocation());
 	}
 
-	// try and play a firing animation if specified
-	if (FireAnimation != nullptr)
+	// try and play a firing animation if specified and already loaded
+	UAnimMontage* fireAnimation = FireAnimation.Get();
+	if (fireAnimation != nullptr)
 	{
 		// Get the animation object for the arms mesh
 		UAnimInstance* AnimInstance = Mesh1P->GetAnimInstance();
 		if (AnimInstance != nullptr)
 		{
-			AnimInstance->Montage_Play(FireAnimation, 1.f);
+			AnimInstance->Montage_Play(fireAnimation, 1.f);
 		}
 	}
 }
 
 void ADiminuatorCharacter::OnReset()
 {
-	UGameplayStatics::OpenLevel(GetWorld(), FName(GetWorld()->GetName()));
+	if (HasAuthority())
+	{
+		ResetRoom();
+	}
+	else
+	{
+		ServerReset();
+	}
+}
+
+void ADiminuatorCharacter::ServerReset_Implementation()
+{
+	ResetRoom();
+}
+
+void ADiminuatorCharacter::ResetRoom()
+{
+	// Streamed rooms reset in place on every machine, otherwise reload the whole map
+	ARoomStreamingManager* roomManager = ARoomStreamingManager::Get(GetWorld());
+	if (roomManager != nullptr)
+	{
+		roomManager->ResetCurrentRoom();
+	}
+	else if (GetNetMode() == NM_Standalone)
+	{
+		UGameplayStatics::OpenLevel(GetWorld(), FName(GetWorld()->GetName()));
+	}
+	else
+	{
+		// Clients travel along instead of being dropped
+		GetWorld()->ServerTravel(TEXT("?Restart"));
+	}
 }
 
 void ADiminuatorCharacter::OnResetVR()
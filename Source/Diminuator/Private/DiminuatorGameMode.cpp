@@ -2,16 +2,97 @@
 
 #include "DiminuatorGameMode.h"
 #include "DiminuatorHUD.h"
-#include "DiminuatorCharacter.h"
-#include "UObject/ConstructorHelpers.h"
+#include "Stress/StressScenarioLoader.h"
+#include "Loading/AssetPreloadSubsystem.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDiminuatorGameMode, Log, All);
 
 ADiminuatorGameMode::ADiminuatorGameMode()
 	: Super()
 {
-	// set default pawn class to our Blueprinted character
-	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnClassFinder(TEXT("/Game/FirstPersonCPP/Blueprints/FirstPersonCharacter"));
-	DefaultPawnClass = PlayerPawnClassFinder.Class;
+	// set default pawn class to our Blueprinted character, loaded in InitGame
+	DefaultPawnSoftClass = TSoftClassPtr<APawn>(FSoftObjectPath(TEXT("/Game/FirstPersonCPP/Blueprints/FirstPersonCharacter.FirstPersonCharacter_C")));
 
 	// use our custom HUD class
 	HUDClass = ADiminuatorHUD::StaticClass();
+
+	StressScenarioLoaderClass = AStressScenarioLoader::StaticClass();
+
+	bPawnClassLoaded = false;
+}
+
+void ADiminuatorGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	// A blueprint game mode that sets its own pawn class keeps it
+	UAssetPreloadSubsystem* preloader = UAssetPreloadSubsystem::Get(this);
+	if (preloader == nullptr || DefaultPawnSoftClass.IsNull() || !IsNativePawnClass())
+	{
+		bPawnClassLoaded = true;
+		return;
+	}
+
+	// Nobody can play without the pawn, HUD and character assets are preloaded on every machine by the subsystem
+	preloader->RequestPreload(TEXT("Pawn"), { DefaultPawnSoftClass.ToSoftObjectPath() }, FStreamableManager::AsyncLoadHighPriority,
+		FStreamableDelegate::CreateUObject(this, &ADiminuatorGameMode::OnPawnClassLoaded));
+}
+
+bool ADiminuatorGameMode::PlayerCanRestart_Implementation(APlayerController* Player)
+{
+	return bPawnClassLoaded && Super::PlayerCanRestart_Implementation(Player);
+}
+
+void ADiminuatorGameMode::OnPawnClassLoaded()
+{
+	bPawnClassLoaded = true;
+
+	UClass* pawnClass = DefaultPawnSoftClass.Get();
+	if (pawnClass != nullptr && IsNativePawnClass())
+	{
+		DefaultPawnClass = pawnClass;
+	}
+
+	// Players that joined while loading are still waiting for a pawn
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		APlayerController* controller = it->Get();
+		if (controller != nullptr && controller->GetPawn() == nullptr && PlayerCanRestart(controller))
+		{
+			RestartPlayer(controller);
+		}
+	}
+}
+
+bool ADiminuatorGameMode::IsNativePawnClass() const
+{
+	// Unset or the engine default, nothing set in a blueprint
+	return DefaultPawnClass == nullptr || DefaultPawnClass->HasAnyClassFlags(CLASS_Native);
+}
+
+void ADiminuatorGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	// Stress runs can use any level, bring a loader if the level has none
+	FString scenarioFile;
+	if (FParse::Value(FCommandLine::Get(), TEXT("StressScenario="), scenarioFile))
+	{
+		TActorIterator<AStressScenarioLoader> it(GetWorld());
+		if (it)
+		{
+			return;
+		}
+
+		if (StressScenarioLoaderClass != nullptr)
+		{
+			GetWorld()->SpawnActor<AStressScenarioLoader>(StressScenarioLoaderClass);
+		}
+		else
+		{
+			UE_LOG(LogDiminuatorGameMode, Warning, TEXT("Stress scenario %s not loaded, the game mode has no StressScenarioLoaderClass"), *scenarioFile);
+		}
+	}
 }
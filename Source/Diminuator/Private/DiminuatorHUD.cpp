@@ -5,13 +5,19 @@
 #include "Engine/Texture2D.h"
 #include "TextureResource.h"
 #include "CanvasItem.h"
-#include "UObject/ConstructorHelpers.h"
 
 ADiminuatorHUD::ADiminuatorHUD()
 {
 	// Set the crosshair texture
-	static ConstructorHelpers::FObjectFinder<UTexture2D> CrosshairTexObj(TEXT("/Game/FirstPerson/Textures/FirstPersonCrosshair"));
-	CrosshairTex = CrosshairTexObj.Object;
+	CrosshairTex = TSoftObjectPtr<UTexture2D>(FSoftObjectPath(TEXT("/Game/FirstPerson/Textures/FirstPersonCrosshair.FirstPersonCrosshair")));
+}
+
+void ADiminuatorHUD::GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const
+{
+	if (!CrosshairTex.IsNull())
+	{
+		OutAssets.Add(CrosshairTex.ToSoftObjectPath());
+	}
 }
 
 
@@ -19,6 +25,13 @@ void ADiminuatorHUD::DrawHUD()
 {
 	Super::DrawHUD();
 
+	// Nothing to draw until the preload is done
+	UTexture2D* crosshairTexture = CrosshairTex.Get();
+	if (crosshairTexture == nullptr)
+	{
+		return;
+	}
+
 	// Draw very simple crosshair
 
 	// find center of the Canvas
@@ -29,7 +42,7 @@ void ADiminuatorHUD::DrawHUD()
 										   (Center.Y + 20.0f));
 
 	// draw the crosshair
-	FCanvasTileItem TileItem( CrosshairDrawPosition, CrosshairTex->Resource, FLinearColor::White);
+	FCanvasTileItem TileItem( CrosshairDrawPosition, crosshairTexture->Resource, FLinearColor::White);
 	TileItem.BlendMode = SE_BLEND_Translucent;
 	//Canvas->DrawItem( TileItem );
 }
@@ -3,6 +3,9 @@
 #include "DiminuatorProjectile.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
+#include "Beam/BeamEventLog.h"
+#include "Diminuator.h"
+#include "Components/ScalableComponent.h"
 
 ADiminuatorProjectile::ADiminuatorProjectile() 
 {
@@ -29,14 +32,35 @@ ADiminuatorProjectile::ADiminuatorProjectile()
 
 	// Die after 3 seconds by default
 	InitialLifeSpan = 3.0f;
+
+	// Spawned by the server, clients only see it move
+	SetReplicates(true);
+	SetReplicateMovement(true);
 }
 
 void ADiminuatorProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
+	// Server owns the physics objects and the projectile
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	LLM_SCOPED_TAG_WITH_STAT(STAT_ProjectileLLM, ELLMTracker::Default);
+
 	// Only add impulse and destroy projectile if we hit a physics
 	if ((OtherActor != nullptr) && (OtherActor != this) && (OtherComp != nullptr) && OtherComp->IsSimulatingPhysics())
 	{
-		OtherComp->AddImpulseAtLocation(GetVelocity() * 100.0f, GetActorLocation());
+		// Out of net dormancy before the impulse moves it
+		UScalableComponent* scalable = OtherActor->FindComponentByClass<UScalableComponent>();
+		if (scalable != nullptr)
+		{
+			scalable->WakeUp();
+		}
+
+		const FVector impulse = GetVelocity() * 100.0f;
+		OtherComp->AddImpulseAtLocation(impulse, GetActorLocation());
+		FBeamEventLog::Record(EBeamEventType::ProjectileImpact, GetInstigator(), OtherActor, Hit.ImpactPoint, impulse.Size());
 
 		Destroy();
 	}
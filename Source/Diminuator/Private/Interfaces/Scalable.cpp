@@ -0,0 +1,20 @@
+// Tequila Works test
+#include "Interfaces/Scalable.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Actor.h"
+
+UObject* IScalable::Find(const UPrimitiveComponent* Component)
+{
+	AActor* owner = (Component != nullptr) ? Component->GetOwner() : nullptr;
+	if (owner == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (owner->Implements<UScalable>())
+	{
+		return owner;
+	}
+	return owner->FindComponentByInterface(UScalable::StaticClass());
+}
@@ -0,0 +1,150 @@
+// Tequila Works test
+#include "Loading/AssetPreloadSubsystem.h"
+
+#include "DiminuatorCharacter.h"
+#include "DiminuatorGameMode.h"
+#include "DiminuatorHUD.h"
+#include "CoreGlobals.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/CoreDelegates.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAssetPreload, Log, All);
+
+void UAssetPreloadSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PendingBatches = 0;
+	PreloadStartTime = 0.0;
+	PreloadEndTime = 0.0;
+	FirstFrameTime = 0.0;
+	bStartupReported = false;
+	bStartupBenchmark = FParse::Param(FCommandLine::Get(), TEXT("StartupBenchmark"));
+
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UAssetPreloadSubsystem::OnEndFrame);
+
+	RequestLocalPreload();
+}
+
+void UAssetPreloadSubsystem::Deinitialize()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+
+	for (const TSharedPtr<FStreamableHandle>& handle : Handles)
+	{
+		handle->CancelHandle();
+	}
+	Handles.Reset();
+
+	Super::Deinitialize();
+}
+
+UAssetPreloadSubsystem* UAssetPreloadSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* world = (WorldContextObject != nullptr) ? WorldContextObject->GetWorld() : nullptr;
+	const UGameInstance* gameInstance = (world != nullptr) ? world->GetGameInstance() : nullptr;
+	return (gameInstance != nullptr) ? gameInstance->GetSubsystem<UAssetPreloadSubsystem>() : nullptr;
+}
+
+void UAssetPreloadSubsystem::RequestPreload(const FString& Name, const TArray<FSoftObjectPath>& Assets, TAsyncLoadPriority Priority, FStreamableDelegate OnLoaded)
+{
+	if (PendingBatches == 0 && PreloadStartTime == 0.0)
+	{
+		PreloadStartTime = FPlatformTime::Seconds();
+	}
+	PendingBatches++;
+
+	const FStreamableDelegate onBatchLoaded = FStreamableDelegate::CreateUObject(this, &UAssetPreloadSubsystem::OnBatchLoaded, Name, Assets.Num(), FPlatformTime::Seconds(), OnLoaded);
+	TSharedPtr<FStreamableHandle> handle = StreamableManager.RequestAsyncLoad(Assets, onBatchLoaded, Priority);
+	if (handle.IsValid())
+	{
+		Handles.Add(handle);
+	}
+	else
+	{
+		// Empty or invalid list, there is no request to call back
+		onBatchLoaded.ExecuteIfBound();
+	}
+}
+
+void UAssetPreloadSubsystem::RequestLocalPreload()
+{
+	const ADiminuatorGameMode* gameMode = GetDefault<ADiminuatorGameMode>();
+
+	// Firing assets are only needed once the player does something, they follow the pawn class
+	LocalPawnClass = gameMode->DefaultPawnSoftClass;
+	if (!LocalPawnClass.IsNull())
+	{
+		RequestPreload(TEXT("LocalPawn"), { LocalPawnClass.ToSoftObjectPath() }, FStreamableManager::AsyncLoadHighPriority,
+			FStreamableDelegate::CreateUObject(this, &UAssetPreloadSubsystem::OnLocalPawnClassLoaded));
+	}
+
+	// HUD assets load along with it, the crosshair can pop in a few frames later
+	const ADiminuatorHUD* hud = (gameMode->HUDClass != nullptr) ? Cast<ADiminuatorHUD>(gameMode->HUDClass->GetDefaultObject()) : nullptr;
+	if (hud != nullptr && !IsRunningDedicatedServer())
+	{
+		TArray<FSoftObjectPath> hudAssets;
+		hud->GetPreloadAssets(hudAssets);
+		RequestPreload(TEXT("HUD"), hudAssets, FStreamableManager::DefaultAsyncLoadPriority);
+	}
+}
+
+void UAssetPreloadSubsystem::OnLocalPawnClassLoaded()
+{
+	const UClass* pawnClass = LocalPawnClass.Get();
+	const ADiminuatorCharacter* character = (pawnClass != nullptr) ? Cast<ADiminuatorCharacter>(pawnClass->GetDefaultObject()) : nullptr;
+	if (character != nullptr)
+	{
+		TArray<FSoftObjectPath> characterAssets;
+		character->GetPreloadAssets(characterAssets);
+		RequestPreload(TEXT("Character"), characterAssets, FStreamableManager::DefaultAsyncLoadPriority - 1);
+	}
+}
+
+void UAssetPreloadSubsystem::OnBatchLoaded(FString Name, int32 NumAssets, double RequestTime, FStreamableDelegate OnLoaded)
+{
+	PendingBatches--;
+	UE_LOG(LogAssetPreload, Log, TEXT("Preloaded %s: %d assets in %.1f ms"), *Name, NumAssets, (FPlatformTime::Seconds() - RequestTime) * 1000.0);
+
+	OnLoaded.ExecuteIfBound();
+
+	if (PendingBatches == 0)
+	{
+		PreloadEndTime = FPlatformTime::Seconds();
+		TryReportStartup();
+	}
+}
+
+void UAssetPreloadSubsystem::OnEndFrame()
+{
+	if (FirstFrameTime == 0.0)
+	{
+		FirstFrameTime = FPlatformTime::Seconds() - GStartTime;
+		TryReportStartup();
+	}
+}
+
+void UAssetPreloadSubsystem::TryReportStartup()
+{
+	// Needs both the first frame and the end of the preload phase
+	if (bStartupReported || FirstFrameTime == 0.0 || PreloadEndTime == 0.0 || PendingBatches > 0)
+	{
+		return;
+	}
+	bStartupReported = true;
+
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+
+	// Benchmark line: first frame ms, preload ms, preload end since process start ms, used memory MB, peak used memory MB
+	const FPlatformMemoryStats memoryStats = FPlatformMemory::GetStats();
+	UE_LOG(LogAssetPreload, Display, TEXT("Startup,%.1f,%.1f,%.1f,%.1f,%.1f"),
+		FirstFrameTime * 1000.0, (PreloadEndTime - PreloadStartTime) * 1000.0, (PreloadEndTime - GStartTime) * 1000.0,
+		memoryStats.UsedPhysical / (1024.0 * 1024.0), memoryStats.PeakUsedPhysical / (1024.0 * 1024.0));
+
+	if (bStartupBenchmark)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
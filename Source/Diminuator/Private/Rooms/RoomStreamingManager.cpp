@@ -0,0 +1,365 @@
+// Tequila Works test
+#include "Rooms/RoomStreamingManager.h"
+
+#include "CoreGlobals.h"
+#include "Engine/World.h"
+#include "Engine/LevelStreamingDynamic.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/PlatformMemory.h"
+#include "Net/UnrealNetwork.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRoomStreaming, Log, All);
+
+ARoomStreamingManager::ARoomStreamingManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	// Every machine streams the rooms itself, following the room and resets of the server
+	bReplicates = true;
+	bAlwaysRelevant = true;
+
+	PreloadAhead = 1;
+	KeepBehind = 1;
+	HitchThresholdMs = 33.3f;
+	TransitionSettleTime = 1.0f;
+
+	ServerRoom = INDEX_NONE;
+	CurrentRoom = INDEX_NONE;
+	ResetOldLevel = nullptr;
+	ResetRoom = INDEX_NONE;
+	bInTransition = false;
+	TransitionStartTime = 0.0;
+	TransitionSettleTimer = 0.0f;
+	WorstFrameMs = 0.0f;
+	HitchFrames = 0;
+	PeakUsedPhysical = 0;
+}
+
+ARoomStreamingManager* ARoomStreamingManager::Get(const UWorld* World)
+{
+	if (World != nullptr)
+	{
+		for (TActorIterator<ARoomStreamingManager> it(const_cast<UWorld*>(World)); it; ++it)
+		{
+			return *it;
+		}
+	}
+	return nullptr;
+}
+
+void ARoomStreamingManager::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ARoomStreamingManager, ServerRoom);
+	DOREPLIFETIME(ARoomStreamingManager, RoomGenerations);
+}
+
+void ARoomStreamingManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	RoomLevels.SetNumZeroed(Rooms.Num());
+	RoomLevelGenerations.SetNumZeroed(Rooms.Num());
+	if (HasAuthority())
+	{
+		RoomGenerations.SetNumZeroed(Rooms.Num());
+		if (Rooms.Num() > 0)
+		{
+			ServerRoom = 0;
+		}
+	}
+
+	// Clients joining late start straight in the room the server is in
+	ApplyRoomState();
+}
+
+void ARoomStreamingManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (ResetOldLevel != nullptr)
+	{
+		UpdateReset();
+	}
+
+	if (!bInTransition)
+	{
+		return;
+	}
+
+	// Game thread time only, GPU and vsync waits are not streaming hitches
+	const float frameMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	WorstFrameMs = FMath::Max(WorstFrameMs, frameMs);
+	if (frameMs > HitchThresholdMs)
+	{
+		HitchFrames++;
+	}
+	PeakUsedPhysical = FMath::Max<uint64>(PeakUsedPhysical, FPlatformMemory::GetStats().UsedPhysical);
+
+	// Keep measuring a bit after the loads, levels still register components when made visible
+	if (IsRoomLoading())
+	{
+		TransitionSettleTimer = TransitionSettleTime;
+	}
+	else
+	{
+		TransitionSettleTimer -= DeltaTime;
+		if (TransitionSettleTimer <= 0.0f)
+		{
+			EndTransition();
+		}
+	}
+}
+
+void ARoomStreamingManager::EnterRoom(int32 Index)
+{
+	if (!HasAuthority() || !Rooms.IsValidIndex(Index))
+	{
+		return;
+	}
+
+	ServerRoom = Index;
+	ApplyRoomState();
+}
+
+void ARoomStreamingManager::AdvanceRoom()
+{
+	EnterRoom(CurrentRoom + 1);
+}
+
+void ARoomStreamingManager::ResetCurrentRoom()
+{
+	// One reset at a time, the pending one already brings a fresh room
+	if (!HasAuthority() || !RoomGenerations.IsValidIndex(CurrentRoom) || ResetOldLevel != nullptr)
+	{
+		return;
+	}
+
+	RoomGenerations[CurrentRoom]++;
+	ApplyRoomState();
+}
+
+void ARoomStreamingManager::OnRep_RoomState()
+{
+	ApplyRoomState();
+}
+
+void ARoomStreamingManager::ApplyRoomState()
+{
+	// Replicated state can come before begin play, the rooms are sized there
+	if (!HasActorBegunPlay() || !Rooms.IsValidIndex(ServerRoom))
+	{
+		return;
+	}
+
+	if (ServerRoom != CurrentRoom)
+	{
+		ShowRoom(ServerRoom);
+	}
+
+	// The server reset the room, a reset still swapping catches up once done
+	if (RoomLevels[CurrentRoom] != nullptr && RoomLevelGenerations[CurrentRoom] != GetRoomGeneration(CurrentRoom))
+	{
+		ReloadCurrentRoom();
+	}
+}
+
+int32 ARoomStreamingManager::GetRoomGeneration(int32 Index) const
+{
+	return RoomGenerations.IsValidIndex(Index) ? RoomGenerations[Index] : 0;
+}
+
+void ARoomStreamingManager::ShowRoom(int32 Index)
+{
+	BeginTransition(FString::Printf(TEXT("Room %d -> %d"), CurrentRoom, Index));
+	CurrentRoom = Index;
+
+	// Current room should already be there thanks to the preload, if not load it now
+	LoadRoom(CurrentRoom);
+	for (int32 i = 1; i <= PreloadAhead; ++i)
+	{
+		LoadRoom(CurrentRoom + i);
+	}
+
+	// Finished rooms and anything too far ahead go away
+	for (int32 i = 0; i < Rooms.Num(); ++i)
+	{
+		if (i < CurrentRoom - KeepBehind || i > CurrentRoom + PreloadAhead)
+		{
+			UnloadRoom(i);
+		}
+	}
+}
+
+void ARoomStreamingManager::ReloadCurrentRoom()
+{
+	if (ResetOldLevel != nullptr)
+	{
+		return;
+	}
+
+	BeginTransition(FString::Printf(TEXT("Reset room %d"), CurrentRoom));
+
+	// Fresh instance of the room, cubes and spawners back to their initial state.
+	// It loads hidden next to the old one, which stays until the swap
+	ULevelStreamingDynamic* oldLevel = RoomLevels[CurrentRoom];
+	const int32 oldGeneration = RoomLevelGenerations[CurrentRoom];
+	RoomLevels[CurrentRoom] = nullptr;
+	LoadRoom(CurrentRoom);
+
+	ULevelStreamingDynamic* newLevel = RoomLevels[CurrentRoom];
+	if (newLevel == nullptr)
+	{
+		RoomLevels[CurrentRoom] = oldLevel;
+		RoomLevelGenerations[CurrentRoom] = oldGeneration;
+		return;
+	}
+
+	if (oldLevel != nullptr)
+	{
+		newLevel->SetShouldBeVisible(false);
+		ResetOldLevel = oldLevel;
+		ResetRoom = CurrentRoom;
+	}
+	else
+	{
+		TeleportPlayersToEntry(CurrentRoom);
+	}
+}
+
+void ARoomStreamingManager::UpdateReset()
+{
+	ULevelStreamingDynamic* newLevel = RoomLevels.IsValidIndex(ResetRoom) ? RoomLevels[ResetRoom] : nullptr;
+	const bool bRoomLeft = (ResetRoom != CurrentRoom) || (newLevel == nullptr);
+
+	if (!bRoomLeft && !newLevel->IsLevelVisible())
+	{
+		// Shown only once loaded, the two instances overlap just while it registers
+		if (newLevel->IsLevelLoaded() && !newLevel->ShouldBeVisible())
+		{
+			newLevel->SetShouldBeVisible(true);
+		}
+		return;
+	}
+
+	UnloadLevel(ResetOldLevel);
+	ResetOldLevel = nullptr;
+
+	// Players left the room while it loaded, they stay where they are
+	if (!bRoomLeft)
+	{
+		TeleportPlayersToEntry(ResetRoom);
+	}
+	ResetRoom = INDEX_NONE;
+
+	// Resets that came in while this one was swapping
+	ApplyRoomState();
+}
+
+void ARoomStreamingManager::TeleportPlayersToEntry(int32 Index)
+{
+	// Pawns move on the server and replicate, clients only swap the room
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	const FTransform entry = Rooms[Index].Entry * Rooms[Index].Transform;
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		APlayerController* controller = it->Get();
+		APawn* pawn = (controller != nullptr) ? controller->GetPawn() : nullptr;
+		if (pawn != nullptr)
+		{
+			pawn->TeleportTo(entry.GetLocation(), entry.Rotator());
+			controller->ClientSetRotation(entry.Rotator());
+		}
+	}
+}
+
+void ARoomStreamingManager::LoadRoom(int32 Index)
+{
+	if (!Rooms.IsValidIndex(Index) || RoomLevels[Index] != nullptr)
+	{
+		return;
+	}
+
+	// Async load, the level becomes visible once loaded and its actors register over several frames.
+	// Same instance name on every machine, so the replicated actors in the room match
+	const FStreamedRoom& room = Rooms[Index];
+	const int32 generation = GetRoomGeneration(Index);
+	const FString instanceName = FString::Printf(TEXT("%s_Room%d_%d"), *GetName(), Index, generation);
+	bool bSuccess = false;
+	RoomLevels[Index] = ULevelStreamingDynamic::LoadLevelInstanceBySoftObjectPtr(this, room.Level, room.Transform.GetLocation(), room.Transform.Rotator(), bSuccess, instanceName);
+	RoomLevelGenerations[Index] = generation;
+	if (!bSuccess)
+	{
+		UE_LOG(LogRoomStreaming, Warning, TEXT("Could not stream room %d (%s)"), Index, *room.Level.ToString());
+	}
+}
+
+void ARoomStreamingManager::UnloadRoom(int32 Index)
+{
+	if (!RoomLevels.IsValidIndex(Index) || RoomLevels[Index] == nullptr)
+	{
+		return;
+	}
+
+	UnloadLevel(RoomLevels[Index]);
+	RoomLevels[Index] = nullptr;
+}
+
+void ARoomStreamingManager::UnloadLevel(ULevelStreamingDynamic* Level)
+{
+	Level->SetShouldBeVisible(false);
+	Level->SetShouldBeLoaded(false);
+	Level->SetIsRequestingUnloadAndRemoval(true);
+}
+
+bool ARoomStreamingManager::IsRoomLoading() const
+{
+	if (ResetOldLevel != nullptr)
+	{
+		return true;
+	}
+
+	for (const ULevelStreamingDynamic* level : RoomLevels)
+	{
+		if (level != nullptr && (!level->IsLevelLoaded() || (level->ShouldBeVisible() && !level->IsLevelVisible())))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void ARoomStreamingManager::BeginTransition(const FString& Name)
+{
+	// A transition on top of another one reports the first
+	if (bInTransition)
+	{
+		EndTransition();
+	}
+
+	bInTransition = true;
+	TransitionName = Name;
+	TransitionStartTime = FPlatformTime::Seconds();
+	TransitionSettleTimer = TransitionSettleTime;
+	WorstFrameMs = 0.0f;
+	HitchFrames = 0;
+	PeakUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+}
+
+void ARoomStreamingManager::EndTransition()
+{
+	bInTransition = false;
+
+	// Benchmark line: name, duration ms, worst game thread frame ms, hitch frames, peak used memory MB, result
+	const double durationMs = (FPlatformTime::Seconds() - TransitionStartTime) * 1000.0;
+	UE_LOG(LogRoomStreaming, Display, TEXT("RoomTransition,%s,%.1f,%.2f,%d,%.1f,%s"),
+		*TransitionName, durationMs, WorstFrameMs, HitchFrames, PeakUsedPhysical / (1024.0 * 1024.0),
+		(HitchFrames > 0) ? TEXT("HITCH") : TEXT("OK"));
+}
@@ -0,0 +1,136 @@
+// Tequila Works test
+#include "Stress/ServerLoadReport.h"
+
+#include "CoreGlobals.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogServerLoad, Log, All);
+
+static TAutoConsoleVariable<float> CVarServerLoadReportInterval(
+	TEXT("server.LoadReport.Interval"),
+	10.0f,
+	TEXT("Seconds between server load report lines."),
+	ECVF_Default);
+
+uint64 UServerLoadReport::BeamCycles = 0;
+int32 UServerLoadReport::ScalableObjects = 0;
+int32 UServerLoadReport::AwakeScalableObjects = 0;
+
+bool UServerLoadReport::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && (IsRunningDedicatedServer() || FParse::Param(FCommandLine::Get(), TEXT("LoadReport")));
+}
+
+void UServerLoadReport::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UServerLoadReport::OnPostActorTick);
+	PostTickFlushHandle = GetWorld()->OnPostTickFlush().AddUObject(this, &UServerLoadReport::OnPostTickFlush);
+}
+
+void UServerLoadReport::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	GetWorld()->OnPostTickFlush().Remove(PostTickFlushHandle);
+
+	Super::Deinitialize();
+}
+
+void UServerLoadReport::OnPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		FlushStartCycles = FPlatformTime::Cycles64();
+	}
+}
+
+void UServerLoadReport::OnPostTickFlush()
+{
+	if (FlushStartCycles != 0)
+	{
+		WindowFlushCycles += FPlatformTime::Cycles64() - FlushStartCycles;
+		FlushStartCycles = 0;
+	}
+}
+
+void UServerLoadReport::Tick(float DeltaTime)
+{
+	const UWorld* world = GetWorld();
+	if (world == nullptr || !world->IsGameWorld())
+	{
+		return;
+	}
+
+	if (WindowFrames == 0)
+	{
+		WindowStartBeamCycles = BeamCycles;
+	}
+
+	// Game thread time only, the idle wait of the server tick rate is not load
+	const float tickMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	TickMsSum += tickMs;
+	WorstTickMs = FMath::Max(WorstTickMs, tickMs);
+	WorstAwakeScalableObjects = FMath::Max(WorstAwakeScalableObjects, AwakeScalableObjects);
+	WindowFrames++;
+
+	WindowTime += DeltaTime;
+	if (WindowTime >= CVarServerLoadReportInterval.GetValueOnGameThread())
+	{
+		Report();
+
+		WindowTime = 0.0f;
+		WindowFrames = 0;
+		TickMsSum = 0.0;
+		WorstTickMs = 0.0f;
+		WindowFlushCycles = 0;
+		WorstAwakeScalableObjects = 0;
+	}
+}
+
+void UServerLoadReport::Report()
+{
+	// Bandwidth per connection, averaged by the net driver over the last second
+	int32 numPlayers = 0;
+	int64 totalOutBytes = 0;
+	int64 totalInBytes = 0;
+	int32 worstOutBytes = 0;
+	const UNetDriver* netDriver = GetWorld()->GetNetDriver();
+	if (netDriver != nullptr)
+	{
+		for (const UNetConnection* connection : netDriver->ClientConnections)
+		{
+			if (connection != nullptr)
+			{
+				numPlayers++;
+				totalOutBytes += connection->OutBytesPerSecond;
+				totalInBytes += connection->InBytesPerSecond;
+				worstOutBytes = FMath::Max(worstOutBytes, connection->OutBytesPerSecond);
+			}
+		}
+	}
+
+	const double avgTickMs = TickMsSum / FMath::Max(WindowFrames, 1);
+	const double beamMs = FPlatformTime::ToMilliseconds64(BeamCycles - WindowStartBeamCycles) / FMath::Max(WindowFrames, 1);
+	const double flushMs = FPlatformTime::ToMilliseconds64(WindowFlushCycles) / FMath::Max(WindowFrames, 1);
+	const int32 divisor = FMath::Max(numPlayers, 1);
+
+	// Benchmark line: players, avg tick ms, worst tick ms, beam ms per frame, net flush ms per frame,
+	// avg out B/s per player, worst out B/s, avg in B/s per player, scalable objects, worst awake scalable objects
+	UE_LOG(LogServerLoad, Display, TEXT("ServerLoad,%d,%.2f,%.2f,%.3f,%.3f,%lld,%d,%lld,%d,%d"),
+		numPlayers, avgTickMs, WorstTickMs, beamMs, flushMs, totalOutBytes / divisor, worstOutBytes, totalInBytes / divisor,
+		ScalableObjects, WorstAwakeScalableObjects);
+}
+
+ETickableTickType UServerLoadReport::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Always;
+}
+
+TStatId UServerLoadReport::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UServerLoadReport, STATGROUP_Tickables);
+}
@@ -0,0 +1,161 @@
+// Tequila Works test
+#include "Stress/StressRoomCommandlet.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Serialization/Archive.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogStressRoom, Log, All);
+
+namespace StressRoom
+{
+	// Generated meshes are 1m cubes scaled to size
+	const float MeshSize = 100.0f;
+	const float WallHeight = 400.0f;
+	const float WallThickness = 10.0f;
+	const float RoomGap = 200.0f;
+}
+
+UStressRoomCommandlet::UStressRoomCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UStressRoomCommandlet::Main(const FString& Params)
+{
+	FString outFile;
+	if (!FParse::Value(*Params, TEXT("Out="), outFile))
+	{
+		UE_LOG(LogStressRoom, Error, TEXT("Missing -Out=<file>"));
+		return 1;
+	}
+	if (FPaths::IsRelative(outFile))
+	{
+		outFile = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("StressScenarios"), outFile);
+	}
+
+	int32 numRooms = 1;
+	int32 numCubes = 100;
+	int32 numGlassWalls = 4;
+	int32 numSpawners = 1;
+	float roomSize = 2000.0f;
+	int32 seed = 0;
+	FParse::Value(*Params, TEXT("Rooms="), numRooms);
+	FParse::Value(*Params, TEXT("Cubes="), numCubes);
+	FParse::Value(*Params, TEXT("GlassWalls="), numGlassWalls);
+	FParse::Value(*Params, TEXT("Spawners="), numSpawners);
+	FParse::Value(*Params, TEXT("RoomSize="), roomSize);
+	FParse::Value(*Params, TEXT("Seed="), seed);
+
+	numRooms = FMath::Clamp(numRooms, 1, (1 << 24) - 1);
+	numCubes = FMath::Max(numCubes, 0);
+	numGlassWalls = FMath::Clamp(numGlassWalls, 0, 4);
+	numSpawners = FMath::Max(numSpawners, 0);
+	roomSize = FMath::Max(roomSize, StressRoom::MeshSize * 2.0f);
+
+	const int64 objectsPerRoom = static_cast<int64>(numCubes) + numGlassWalls + 1 + numSpawners;
+	const int64 numObjects = objectsPerRoom * numRooms;
+	if (numObjects > MAX_int32)
+	{
+		UE_LOG(LogStressRoom, Error, TEXT("Too many objects (%lld)"), numObjects);
+		return 1;
+	}
+
+	TArray<FStressScenarioObject> objects;
+	objects.Reserve(static_cast<int32>(numObjects));
+
+	// Rooms on a square grid
+	FRandomStream random(seed);
+	const int32 gridSide = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(numRooms)));
+	const float roomStride = roomSize + StressRoom::RoomGap;
+	for (int32 room = 0; room < numRooms; ++room)
+	{
+		const FVector origin((room % gridSide) * roomStride, (room / gridSide) * roomStride, 0.0f);
+		GenerateRoom(room, origin, roomSize, numCubes, numGlassWalls, numSpawners, random, objects);
+	}
+
+	FStressScenarioHeader header;
+	FMemory::Memzero(header);
+	header.Magic = STRESS_SCENARIO_MAGIC;
+	header.Version = STRESS_SCENARIO_VERSION;
+	header.NumObjects = objects.Num();
+	header.NumRooms = numRooms;
+	header.Seed = seed;
+	header.RoomSize = roomSize;
+
+	TUniquePtr<FArchive> writer(IFileManager::Get().CreateFileWriter(*outFile));
+	if (!writer)
+	{
+		UE_LOG(LogStressRoom, Error, TEXT("Could not open %s for writing"), *outFile);
+		return 1;
+	}
+	writer->Serialize(&header, sizeof(header));
+	writer->Serialize(objects.GetData(), objects.Num() * sizeof(FStressScenarioObject));
+	const bool bOk = writer->Close();
+
+	UE_LOG(LogStressRoom, Display, TEXT("Wrote %d rooms, %d objects to %s"), numRooms, objects.Num(), *outFile);
+	return bOk ? 0 : 1;
+}
+
+void UStressRoomCommandlet::GenerateRoom(uint32 RoomIndex, const FVector& Origin, float RoomSize, int32 NumCubes, int32 NumGlassWalls, int32 NumSpawners, FRandomStream& Random, TArray<FStressScenarioObject>& OutObjects) const
+{
+	using namespace StressRoom;
+
+	const float halfRoom = RoomSize * 0.5f;
+	const FVector center = Origin + FVector(halfRoom, halfRoom, 0.0f);
+
+	// Glass walls around the room, north, east, south, west
+	static const FVector wallDirections[] = { FVector(1.0f, 0.0f, 0.0f), FVector(0.0f, 1.0f, 0.0f), FVector(-1.0f, 0.0f, 0.0f), FVector(0.0f, -1.0f, 0.0f) };
+	for (int32 i = 0; i < NumGlassWalls; ++i)
+	{
+		const FVector location = center + wallDirections[i] * halfRoom + FVector(0.0f, 0.0f, WallHeight * 0.5f);
+		const float yaw = (i % 2 == 0) ? 90.0f : 0.0f;
+		OutObjects.Add(MakeObject(EStressObjectType::GlassWall, RoomIndex, location, yaw, FVector(RoomSize / MeshSize, WallThickness / MeshSize, WallHeight / MeshSize)));
+	}
+
+	// Glass ceiling
+	OutObjects.Add(MakeObject(EStressObjectType::GlassCeiling, RoomIndex, center + FVector(0.0f, 0.0f, WallHeight), 0.0f, FVector(RoomSize / MeshSize, RoomSize / MeshSize, WallThickness / MeshSize)));
+
+	// Spawners hang under the ceiling
+	for (int32 i = 0; i < NumSpawners; ++i)
+	{
+		const FVector location(Origin.X + Random.FRandRange(MeshSize, RoomSize - MeshSize), Origin.Y + Random.FRandRange(MeshSize, RoomSize - MeshSize), WallHeight - MeshSize);
+		OutObjects.Add(MakeObject(EStressObjectType::Spawner, RoomIndex, location, 0.0f, FVector::OneVector));
+	}
+
+	// Cubes on a jittered floor grid, stacked in layers when the room is crowded
+	const float cellSize = MeshSize * 1.5f;
+	const int32 cellsPerSide = FMath::Max(1, FMath::FloorToInt((RoomSize - MeshSize * 2.0f) / cellSize));
+	const int32 cellsPerLayer = cellsPerSide * cellsPerSide;
+	const float jitter = (cellSize - MeshSize * 1.2f) * 0.5f;
+	for (int32 i = 0; i < NumCubes; ++i)
+	{
+		const int32 cell = i % cellsPerLayer;
+		const int32 layer = i / cellsPerLayer;
+		const FVector location(
+			Origin.X + MeshSize + ((cell % cellsPerSide) + 0.5f) * cellSize + Random.FRandRange(-jitter, jitter),
+			Origin.Y + MeshSize + ((cell / cellsPerSide) + 0.5f) * cellSize + Random.FRandRange(-jitter, jitter),
+			(layer + 0.5f) * cellSize);
+		OutObjects.Add(MakeObject(EStressObjectType::Cube, RoomIndex, location, 0.0f, FVector(Random.FRandRange(0.5f, 1.2f))));
+	}
+}
+
+FStressScenarioObject UStressRoomCommandlet::MakeObject(EStressObjectType Type, uint32 RoomIndex, const FVector& Location, float Yaw, const FVector& Scale)
+{
+	FStressScenarioObject object;
+	object.Location[0] = Location.X;
+	object.Location[1] = Location.Y;
+	object.Location[2] = Location.Z;
+	object.Yaw = Yaw;
+	object.Scale[0] = Scale.X;
+	object.Scale[1] = Scale.Y;
+	object.Scale[2] = Scale.Z;
+	object.Type = static_cast<uint8>(Type);
+	object.Room[0] = RoomIndex & 0xFF;
+	object.Room[1] = (RoomIndex >> 8) & 0xFF;
+	object.Room[2] = (RoomIndex >> 16) & 0xFF;
+	return object;
+}
@@ -0,0 +1,219 @@
+// Tequila Works test
+#include "Stress/StressScenarioLoader.h"
+
+#include "Engine/World.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/Paths.h"
+#include "Components/ScalableComponent.h"
+#include "Loading/AssetPreloadSubsystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogStressScenario, Log, All);
+
+namespace StressScenarioLoader
+{
+	namespace
+	{
+		// Same order as EStressObjectType
+		const TCHAR* ObjectTypeNames[] = { TEXT("Cube"), TEXT("GlassWall"), TEXT("GlassCeiling"), TEXT("Spawner") };
+		static_assert(UE_ARRAY_COUNT(ObjectTypeNames) == static_cast<int32>(EStressObjectType::Count), "Missing stress object type names");
+	}
+}
+
+AStressScenarioLoader::AStressScenarioLoader()
+{
+	// Only ticks while spawning
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	CubeClass = TSoftClassPtr<AActor>(FSoftObjectPath(TEXT("/Game/FirstPersonCPP/Blueprints/BP_Cube.BP_Cube_C")));
+	GlassWallClass = TSoftClassPtr<AActor>(FSoftObjectPath(TEXT("/Game/FirstPersonCPP/Blueprints/BP_GlassWall.BP_GlassWall_C")));
+	GlassCeilingClass = TSoftClassPtr<AActor>(FSoftObjectPath(TEXT("/Game/FirstPersonCPP/Blueprints/BP_GlassCeiling.BP_GlassCeiling_C")));
+	SpawnerClass = TSoftClassPtr<AActor>(FSoftObjectPath(TEXT("/Game/FirstPersonCPP/Blueprints/BP_Spawner.BP_Spawner_C")));
+
+	SpawnBudgetMs = 4.0f;
+	NextObject = 0;
+	NumSkipped = 0;
+	LoadStartTime = 0.0;
+}
+
+void AStressScenarioLoader::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Spawned objects replicate, clients must not spawn their own copies
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// Command line wins so the same map can run any scenario
+	FString fileName = ScenarioFile;
+	FParse::Value(FCommandLine::Get(), TEXT("StressScenario="), fileName);
+	if (!fileName.IsEmpty())
+	{
+		LoadScenario(fileName);
+	}
+}
+
+void AStressScenarioLoader::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Unmap();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool AStressScenarioLoader::LoadScenario(const FString& FileName)
+{
+	Unmap();
+	SetActorTickEnabled(false);
+
+	if (!HasAuthority())
+	{
+		UE_LOG(LogStressScenario, Warning, TEXT("Stress scenario %s not loaded, only the server spawns scenarios"), *FileName);
+		return false;
+	}
+
+	FString path = FileName;
+	if (FPaths::IsRelative(path))
+	{
+		path = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("StressScenarios"), path);
+	}
+
+	LoadStartTime = FPlatformTime::Seconds();
+
+	IPlatformFile& platformFile = FPlatformFileManager::Get().GetPlatformFile();
+	MappedFile.Reset(platformFile.OpenMapped(*path));
+	if (MappedFile)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+
+	if (!MappedRegion || !Scenario.Init(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize()))
+	{
+		UE_LOG(LogStressScenario, Error, TEXT("Could not map stress scenario %s"), *path);
+		Unmap();
+		return false;
+	}
+
+	UE_LOG(LogStressScenario, Display, TEXT("Loading stress scenario %s: %u rooms, %d objects"), *path, Scenario.Header->NumRooms, Scenario.Num());
+
+	NextObject = 0;
+	NumSkipped = 0;
+
+	// Classes load in the background, spawning starts once they are in
+	const TSoftClassPtr<AActor> classes[] = { CubeClass, GlassWallClass, GlassCeilingClass, SpawnerClass };
+	static_assert(UE_ARRAY_COUNT(classes) == static_cast<int32>(EStressObjectType::Count), "Missing stress object classes");
+	UAssetPreloadSubsystem* preloader = UAssetPreloadSubsystem::Get(this);
+	if (preloader != nullptr)
+	{
+		TArray<FSoftObjectPath> classPaths;
+		for (const TSoftClassPtr<AActor>& objectClass : classes)
+		{
+			if (!objectClass.IsNull())
+			{
+				classPaths.Add(objectClass.ToSoftObjectPath());
+			}
+		}
+		preloader->RequestPreload(TEXT("StressScenario"), classPaths, FStreamableManager::DefaultAsyncLoadPriority,
+			FStreamableDelegate::CreateUObject(this, &AStressScenarioLoader::OnClassesLoaded));
+	}
+	else
+	{
+		for (const TSoftClassPtr<AActor>& objectClass : classes)
+		{
+			objectClass.LoadSynchronous();
+		}
+		OnClassesLoaded();
+	}
+	return true;
+}
+
+void AStressScenarioLoader::OnClassesLoaded()
+{
+	// Unmapped or loading another scenario since the request
+	if (Scenario.Header == nullptr || IsActorTickEnabled())
+	{
+		return;
+	}
+
+	using namespace StressScenarioLoader;
+
+	const TSoftClassPtr<AActor> classes[] = { CubeClass, GlassWallClass, GlassCeilingClass, SpawnerClass };
+	ObjectClasses.Reset();
+	for (int32 i = 0; i < static_cast<int32>(EStressObjectType::Count); ++i)
+	{
+		UClass* objectClass = classes[i].Get();
+		if (objectClass == nullptr)
+		{
+			UE_LOG(LogStressScenario, Warning, TEXT("No %s class (%s), those objects are skipped"), ObjectTypeNames[i], classes[i].IsNull() ? TEXT("not set") : *classes[i].ToString());
+		}
+		ObjectClasses.Add(objectClass);
+	}
+
+	SetActorTickEnabled(true);
+}
+
+void AStressScenarioLoader::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double budgetEnd = FPlatformTime::Seconds() + SpawnBudgetMs / 1000.0;
+	const int32 numObjects = Scenario.Num();
+	while (NextObject < numObjects)
+	{
+		SpawnObject(Scenario.Objects[NextObject++]);
+
+		// Check the clock every few spawns, it is not free either
+		if ((NextObject & 15) == 0 && FPlatformTime::Seconds() > budgetEnd)
+		{
+			break;
+		}
+	}
+
+	if (NextObject >= numObjects)
+	{
+		UE_LOG(LogStressScenario, Display, TEXT("Stress scenario populated: %d objects in %.1f ms"), numObjects - NumSkipped, (FPlatformTime::Seconds() - LoadStartTime) * 1000.0);
+		if (NumSkipped > 0)
+		{
+			UE_LOG(LogStressScenario, Warning, TEXT("%d stress scenario objects skipped, their classes are missing"), NumSkipped);
+		}
+		Unmap();
+		SetActorTickEnabled(false);
+	}
+}
+
+void AStressScenarioLoader::SpawnObject(const FStressScenarioObject& Object)
+{
+	// Missing classes were reported once when loaded
+	const TSubclassOf<AActor> actorClass = ObjectClasses.IsValidIndex(Object.Type) ? ObjectClasses[Object.Type] : nullptr;
+	if (actorClass == nullptr)
+	{
+		NumSkipped++;
+		return;
+	}
+
+	const FTransform transform(
+		FRotator(0.0f, Object.Yaw, 0.0f),
+		FVector(Object.Location[0], Object.Location[1], Object.Location[2]),
+		FVector(Object.Scale[0], Object.Scale[1], Object.Scale[2]));
+
+	FActorSpawnParameters params;
+	params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	params.Owner = this;
+	AActor* actor = GetWorld()->SpawnActor<AActor>(actorClass, transform, params);
+
+	// Stress cubes are always scalable, so dormancy is measured even if the cube class has no component
+	if (actor != nullptr && static_cast<EStressObjectType>(Object.Type) == EStressObjectType::Cube && actor->FindComponentByClass<UScalableComponent>() == nullptr)
+	{
+		UScalableComponent* scalable = NewObject<UScalableComponent>(actor);
+		actor->AddInstanceComponent(scalable);
+		scalable->RegisterComponent();
+	}
+}
+
+void AStressScenarioLoader::Unmap()
+{
+	Scenario = FStressScenarioView();
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
@@ -0,0 +1,235 @@
+// Tequila Works test
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/MemoryBase.h"
+#include "Components/BeamComponent.h"
+#include "Tests/BeamTestWorld.h"
+
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace BeamAllocationTest
+{
+	namespace
+	{
+		// Frames to let every cache and scratch buffer reach its size before counting.
+		// Counted frames cover a few latency measurements and collision commits
+		const int32 WarmUpFrames = 8;
+		const int32 CountedFrames = 60;
+		const float FrameTime = 1.0f / 60.0f;
+
+		/*
+		* Sits on top of GMalloc while installed and counts the game thread allocations
+		* made between Begin and End, everything is forwarded to the allocator below.
+		*/
+		class FAllocationCounter : public FMalloc
+		{
+		public:
+
+			FAllocationCounter()
+				: Inner(GMalloc)
+				, NumAllocations(0)
+				, bCounting(false)
+			{
+				GMalloc = this;
+			}
+
+			virtual ~FAllocationCounter()
+			{
+				GMalloc = Inner;
+			}
+
+			void Begin() { bCounting = true; }
+			void End() { bCounting = false; }
+			int32 Num() const { return NumAllocations.load(); }
+
+			virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+			{
+				Record();
+				return Inner->Malloc(Count, Alignment);
+			}
+
+			virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+			{
+				Record();
+				return Inner->TryMalloc(Count, Alignment);
+			}
+
+			virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+			{
+				if (Count > 0)
+				{
+					Record();
+				}
+				return Inner->Realloc(Original, Count, Alignment);
+			}
+
+			virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+			{
+				if (Count > 0)
+				{
+					Record();
+				}
+				return Inner->TryRealloc(Original, Count, Alignment);
+			}
+
+			virtual void Free(void* Original) override { Inner->Free(Original); }
+			virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+			virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+			virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+			virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+			virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+			virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+			virtual void UpdateStats() override { Inner->UpdateStats(); }
+			virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+			virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+			virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+			virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+			virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+		private:
+
+			void Record()
+			{
+				// Other threads keep allocating for themselves while the beam ticks
+				if (bCounting && IsInGameThread())
+				{
+					NumAllocations++;
+				}
+			}
+
+			FMalloc* Inner;
+			std::atomic<int32> NumAllocations;
+			bool bCounting;
+		};
+
+		struct FAllocationResult
+		{
+			// Beam frames without a collision commit, must not allocate
+			int32 FrameAllocations = 0;
+
+			// Frames the physics body got the previewed scale, rebuilding it allocates by design
+			int32 CommitFrames = 0;
+			int32 CommitAllocations = 0;
+		};
+
+		/*
+		* Beam ticks and late updates by hand, only those are counted, the rest of the frame runs as usual.
+		* The late update left pending for the world tick is already done by then.
+		*/
+		FAllocationResult CountBeamFrameAllocations(FBeamTestWorld& TestWorld, UBeamComponent* Beam, const UPrimitiveComponent* Target)
+		{
+			UWorld* world = TestWorld.GetWorld();
+			auto runBeamFrame = [world, Beam]()
+			{
+				Beam->TickComponent(FrameTime, LEVELTICK_All, &Beam->PrimaryComponentTick);
+				FWorldDelegates::OnWorldPostActorTick.Broadcast(world, LEVELTICK_All, FrameTime);
+			};
+
+			for (int32 i = 0; i < WarmUpFrames; ++i)
+			{
+				runBeamFrame();
+				TestWorld.Tick(FrameTime);
+			}
+
+			FAllocationResult result;
+			FAllocationCounter counter;
+			for (int32 i = 0; i < CountedFrames; ++i)
+			{
+				const FVector committedScale = (Target != nullptr) ? Target->GetRelativeScale3D() : FVector::OneVector;
+				const int32 previousAllocations = counter.Num();
+
+				counter.Begin();
+				runBeamFrame();
+				counter.End();
+
+				const int32 allocations = counter.Num() - previousAllocations;
+				if (Target != nullptr && !Target->GetRelativeScale3D().Equals(committedScale, 0.0f))
+				{
+					result.CommitFrames++;
+					result.CommitAllocations += allocations;
+				}
+				else
+				{
+					result.FrameAllocations += allocations;
+				}
+				TestWorld.Tick(FrameTime);
+			}
+			return result;
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBeamTickAllocationTest, "Diminuator.Beam.TickAllocations", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBeamTickAllocationTest::RunTest(const FString& Parameters)
+{
+	using namespace BeamAllocationTest;
+
+	FBeamTestWorld testWorld;
+	ADiminuatorCharacter* character = testWorld.SpawnPlayer();
+	if (!TestNotNull(TEXT("Character"), character) || !TestNotNull(TEXT("Beam"), character->GetBeamComponent()))
+	{
+		return false;
+	}
+	UBeamComponent* beam = character->GetBeamComponent();
+	beam->SetComponentTickEnabled(false);
+	beam->BeamRange = 1000.0f;
+
+	// Slow enough to keep scaling for the whole phase, commit settings stay the defaults
+	beam->BeamScaleSpeed = 0.1f;
+
+	// Floating physics cube in front of the muzzle, a wall next to it so growing probes clearance
+	UStaticMeshComponent* cube = testWorld.SpawnCube(FVector(400.0f, 0.0f, 100.0f), FVector::OneVector, TEXT("Scalable"), true);
+	UStaticMeshComponent* wall = testWorld.SpawnCube(FVector(400.0f, 130.0f, 100.0f), FVector(3.0f, 0.2f, 3.0f), TEXT("BlockAll"), false);
+	if (!TestNotNull(TEXT("Cube"), cube) || !TestNotNull(TEXT("Wall"), wall))
+	{
+		return false;
+	}
+
+	// Simulated controller, aiming away from the cube until told otherwise
+	float aimYaw = 180.0f;
+	beam->AimPoseSource.BindLambda([&aimYaw](FBeamAimPose& OutPose)
+	{
+		OutPose.Location = FVector(0.0f, 0.0f, 100.0f);
+		OutPose.Rotation = FRotator(0.0f, aimYaw, 0.0f);
+		OutPose.SampleTime = FPlatformTime::Seconds();
+		return true;
+	});
+
+	auto checkPhase = [this](const TCHAR* Phase, const FAllocationResult& Result, bool bCommits)
+	{
+		TestEqual(FString::Printf(TEXT("Allocations of %s beam frames"), Phase), Result.FrameAllocations, 0);
+		if (bCommits)
+		{
+			// One rebuild every ScaleCommitInterval at most
+			TestTrue(FString::Printf(TEXT("Collision commits while %s"), Phase), Result.CommitFrames > 0 && Result.CommitFrames <= CountedFrames / 10);
+			AddInfo(FString::Printf(TEXT("%s: %d collision commits, %d allocations"), Phase, Result.CommitFrames, Result.CommitAllocations));
+		}
+	};
+
+	// Held on nothing
+	beam->OnStartFire(BeamMode::DIMINUATOR);
+	checkPhase(TEXT("idle"), CountBeamFrameAllocations(testWorld, beam, nullptr), false);
+
+	// Shrinking the cube
+	aimYaw = 0.0f;
+	checkPhase(TEXT("shrinking"), CountBeamFrameAllocations(testWorld, beam, cube), true);
+
+	// Growing it toward the wall, clearance probes through the proximity shell and the query scheduler
+	beam->OnStopFire(BeamMode::DIMINUATOR);
+	beam->OnStartFire(BeamMode::AUGMENTATOR);
+	checkPhase(TEXT("growing"), CountBeamFrameAllocations(testWorld, beam, cube), true);
+
+	// Both triggers, the cube is grabbed during the warm up
+	beam->OnStartFire(BeamMode::DIMINUATOR);
+	checkPhase(TEXT("grabbing"), CountBeamFrameAllocations(testWorld, beam, nullptr), false);
+	TestTrue(TEXT("Grabbing"), beam->IsGrabbing());
+
+	beam->OnStopFire(BeamMode::DIMINUATOR);
+	beam->OnStopFire(BeamMode::AUGMENTATOR);
+	return true;
+}
+
+#endif
@@ -0,0 +1,121 @@
+// Tequila Works test
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/IConsoleManager.h"
+#include "RenderingThread.h"
+#include "Engine/Level.h"
+#include "Components/BeamComponent.h"
+#include "Tests/BeamTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace BeamLatencyTest
+{
+	namespace
+	{
+		const int32 NumFrames = 8;
+		const float FrameTime = 1.0f / 60.0f;
+
+		// Every pose is already a bit old when sampled, like a tracking system pose
+		const double PoseAge = 0.005;
+
+		// Game thread work between the beam tick and the late update, over a frame whatever the sleep granularity
+		const float FrameWorkTime = 1.5f * FrameTime;
+
+		/* Stands for the rest of the game thread work, after the beam ticked and before the late update */
+		struct FFrameWorkTickFunction : public FTickFunction
+		{
+			virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override
+			{
+				FPlatformProcess::Sleep(FrameWorkTime);
+			}
+
+			virtual FString DiagnosticMessage() override
+			{
+				return TEXT("BeamLatencyTest frame work");
+			}
+		};
+
+		struct FLatencyResult
+		{
+			float Latency = 0.0f;
+			int32 NumSamples = 0;
+		};
+
+		/* Fires at a simulated controller for NumFrames and returns the last latency measured on the RHI thread */
+		FLatencyResult MeasureLatency(bool bLateUpdate)
+		{
+			FLatencyResult result;
+
+			FBeamTestWorld testWorld;
+			ADiminuatorCharacter* character = testWorld.SpawnPlayer();
+			UBeamComponent* beam = (character != nullptr) ? character->GetBeamComponent() : nullptr;
+			if (beam == nullptr)
+			{
+				return result;
+			}
+
+			FFrameWorkTickFunction frameWork;
+			frameWork.bCanEverTick = true;
+			frameWork.TickGroup = TG_PostUpdateWork;
+			frameWork.RegisterTickFunction(testWorld.GetWorld()->PersistentLevel);
+
+			// Simulated controller sweeping to the right
+			beam->bLateUpdate = bLateUpdate;
+			beam->AimPoseSource.BindLambda([&result](FBeamAimPose& OutPose)
+			{
+				OutPose.Location = FVector(0.0f, 0.0f, 100.0f);
+				OutPose.Rotation = FRotator(0.0f, result.NumSamples * 2.0f, 0.0f);
+				OutPose.SampleTime = FPlatformTime::Seconds() - PoseAge;
+				result.NumSamples++;
+				return true;
+			});
+
+			beam->OnStartFire(BeamMode::DIMINUATOR);
+			for (int32 i = 0; i < NumFrames; ++i)
+			{
+				// The RHI thread times the frame once it is submitted, read back the next frame
+				testWorld.Tick(FrameTime);
+				FlushRenderingCommands();
+			}
+			beam->OnStopFire(BeamMode::DIMINUATOR);
+
+			result.Latency = beam->GetMotionToBeamLatency();
+			frameWork.UnRegisterTickFunction();
+			return result;
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBeamSimulatedPoseLatencyTest, "Diminuator.Beam.SimulatedPoseLatency", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBeamSimulatedPoseLatencyTest::RunTest(const FString& Parameters)
+{
+	using namespace BeamLatencyTest;
+
+	// Measure every frame for the test
+	IConsoleVariable* sampleFrames = IConsoleManager::Get().FindConsoleVariable(TEXT("beam.LatencySampleFrames"));
+	if (!TestNotNull(TEXT("beam.LatencySampleFrames"), sampleFrames))
+	{
+		return false;
+	}
+	const int32 previousSampleFrames = sampleFrames->GetInt();
+	sampleFrames->Set(1);
+
+	const FLatencyResult traced = MeasureLatency(false);
+	const FLatencyResult late = MeasureLatency(true);
+
+	sampleFrames->Set(previousSampleFrames);
+
+	// Without the late update the beam is drawn with the traced pose, with it the pose is sampled again
+	TestEqual(TEXT("Aim pose samples without late update"), traced.NumSamples, NumFrames);
+	TestEqual(TEXT("Aim pose samples with late update"), late.NumSamples, NumFrames * 2);
+
+	TestTrue(TEXT("Latency counts the pose age"), late.Latency >= PoseAge);
+	TestTrue(FString::Printf(TEXT("Late update saves a frame (%.1f ms without, %.1f ms with)"), traced.Latency * 1000.0f, late.Latency * 1000.0f),
+		traced.Latency - late.Latency >= FrameTime);
+
+	return true;
+}
+
+#endif
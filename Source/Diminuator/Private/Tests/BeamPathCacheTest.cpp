@@ -0,0 +1,161 @@
+// Tequila Works test
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/IConsoleManager.h"
+#include "Beam/BeamPath.h"
+#include "Tests/BeamTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace BeamPathCacheTest
+{
+	namespace
+	{
+		const FVector Start(0.0f, 0.0f, 100.0f);
+		const FVector Direction(1.0f, 0.0f, 0.0f);
+		const float Range = 1000.0f;
+
+		// Cubes along the beam, off it but inside the watch distance
+		const int32 NumSideCubes = 6;
+		const float SideOffset = 80.0f;
+
+		const int32 BenchIterations = 1000;
+
+		/* Beam through a glass pane onto a wall, movable cubes on both sides of it */
+		struct FPathScene
+		{
+			UStaticMeshComponent* Glass = nullptr;
+			UStaticMeshComponent* Wall = nullptr;
+			TArray<UStaticMeshComponent*> SideCubes;
+
+			explicit FPathScene(FBeamTestWorld& TestWorld)
+			{
+				Glass = TestWorld.SpawnCube(Start + FVector(400.0f, 0.0f, 0.0f), FVector(0.2f, 3.0f, 3.0f), TEXT("Glass"), false);
+				Wall = TestWorld.SpawnCube(Start + FVector(800.0f, 0.0f, 0.0f), FVector(0.2f, 5.0f, 5.0f), TEXT("BlockAll"), false);
+				for (int32 i = 0; i < NumSideCubes; ++i)
+				{
+					const float side = (i % 2 == 0) ? SideOffset : -SideOffset;
+					SideCubes.Add(TestWorld.SpawnCube(Start + FVector(150.0f + i * 100.0f, side, 0.0f), FVector::OneVector, TEXT("Scalable"), false));
+				}
+			}
+
+			bool IsValid() const { return Glass != nullptr && Wall != nullptr && !SideCubes.Contains(nullptr); }
+		};
+
+		/* Sets a console variable for the scope of the test */
+		struct FScopedCVar
+		{
+			IConsoleVariable* Variable;
+			FString PreviousValue;
+
+			FScopedCVar(const TCHAR* Name, const TCHAR* Value)
+				: Variable(IConsoleManager::Get().FindConsoleVariable(Name))
+			{
+				if (Variable != nullptr)
+				{
+					PreviousValue = Variable->GetString();
+					Variable->Set(Value);
+				}
+			}
+
+			~FScopedCVar()
+			{
+				if (Variable != nullptr)
+				{
+					Variable->Set(*PreviousValue);
+				}
+			}
+		};
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBeamPathCacheIntrusionTest, "Diminuator.Beam.PathCache.Intrusion", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBeamPathCacheIntrusionTest::RunTest(const FString& Parameters)
+{
+	using namespace BeamPathCacheTest;
+
+	FBeamTestWorld testWorld;
+	FPathScene scene(testWorld);
+	if (!TestTrue(TEXT("Scene spawned"), scene.IsValid()))
+	{
+		return false;
+	}
+
+	const FCollisionQueryParams params(TEXT("BeamPathCacheTest"), false);
+	FBeamPathTracer tracer;
+	FBeamPath path;
+
+	tracer.Trace(testWorld.GetWorld(), Start, Direction, Range, params, path);
+	TestFalse(TEXT("First trace queries the scene"), path.bCached);
+	TestTrue(TEXT("Beam ends on the wall"), path.bHit && path.TargetHit.GetComponent() == scene.Wall);
+
+	tracer.Trace(testWorld.GetWorld(), Start, Direction, Range, params, path);
+	TestTrue(TEXT("Nothing moved, cached"), path.bCached);
+
+	// Moved closer but still off the beam
+	UStaticMeshComponent* sideCube = scene.SideCubes[0];
+	sideCube->SetWorldLocation(sideCube->GetComponentLocation() - FVector(0.0f, 10.0f, 0.0f));
+	tracer.Trace(testWorld.GetWorld(), Start, Direction, Range, params, path);
+	TestTrue(TEXT("Body moved next to the beam, still cached"), path.bCached);
+
+	// Moved into the beam
+	UStaticMeshComponent* intruder = scene.SideCubes[1];
+	intruder->SetWorldLocation(FVector(intruder->GetComponentLocation().X, 0.0f, Start.Z));
+	tracer.Trace(testWorld.GetWorld(), Start, Direction, Range, params, path);
+	TestFalse(TEXT("Body moved into the beam, traced again"), path.bCached);
+	TestTrue(TEXT("Beam ends on the intruder"), path.bHit && path.TargetHit.GetComponent() == intruder);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBeamPathCacheCostTest, "Diminuator.Beam.PathCache.Cost", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBeamPathCacheCostTest::RunTest(const FString& Parameters)
+{
+	using namespace BeamPathCacheTest;
+
+	FBeamTestWorld testWorld;
+	FPathScene scene(testWorld);
+	if (!TestTrue(TEXT("Scene spawned"), scene.IsValid()))
+	{
+		return false;
+	}
+
+	// Every iteration runs in the same frame, nothing may be refused
+	FScopedCVar maxPerFrame(TEXT("beam.Query.MaxPerFrame"), TEXT("2147483647"));
+	FScopedCVar budgetMs(TEXT("beam.Query.BudgetMs"), TEXT("0"));
+
+	const FCollisionQueryParams params(TEXT("BeamPathCacheTest"), false);
+	FBeamPathTracer tracer;
+	FBeamPath path;
+
+	// Trace and gather the watched bodies every time
+	const double missStart = FPlatformTime::Seconds();
+	for (int32 i = 0; i < BenchIterations; ++i)
+	{
+		tracer.Invalidate();
+		tracer.Trace(testWorld.GetWorld(), Start, Direction, Range, params, path);
+	}
+	const double missSeconds = FPlatformTime::Seconds() - missStart;
+	TestFalse(TEXT("Invalidated path traced"), path.bCached);
+
+	// Only where the path and watched bodies are now
+	const double hitStart = FPlatformTime::Seconds();
+	for (int32 i = 0; i < BenchIterations; ++i)
+	{
+		tracer.Trace(testWorld.GetWorld(), Start, Direction, Range, params, path);
+	}
+	const double hitSeconds = FPlatformTime::Seconds() - hitStart;
+	TestTrue(TEXT("Path reused"), path.bCached);
+
+	// Benchmark line: iterations, watched bodies, us per miss, us per hit
+	const double missUs = missSeconds * 1.e6 / BenchIterations;
+	const double hitUs = hitSeconds * 1.e6 / BenchIterations;
+	AddInfo(FString::Printf(TEXT("BeamPathCache,%d,%d,%.2f,%.2f"), BenchIterations, NumSideCubes, missUs, hitUs));
+	TestTrue(FString::Printf(TEXT("Cache hit cheaper than a trace (%.2f us hit, %.2f us miss)"), hitUs, missUs), hitUs < missUs);
+
+	return true;
+}
+
+#endif
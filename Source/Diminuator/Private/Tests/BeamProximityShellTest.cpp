@@ -0,0 +1,120 @@
+// Tequila Works test
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Components/BeamComponent.h"
+#include "Beam/BeamProximityShell.h"
+#include "Tests/BeamTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace BeamProximityShellTest
+{
+	namespace
+	{
+		// Cube in front of the muzzle, squeezed between a glass wall on one side and another scalable cube on the other
+		const FVector TargetLocation(400.0f, 0.0f, 100.0f);
+		const float BlockerDistance = 130.0f;
+		const float BlockerHalfThickness = 10.0f;
+
+		// Space left to grow, the cube can overshoot it by the last frame of scaling
+		const float GrowthGap = BlockerDistance - BlockerHalfThickness;
+		const float GrowthTolerance = 10.0f;
+
+		bool Contains(const TArray<TWeakObjectPtr<UPrimitiveComponent>>& Bodies, const UPrimitiveComponent* Body)
+		{
+			return Bodies.ContainsByPredicate([Body](const TWeakObjectPtr<UPrimitiveComponent>& Other) { return Other.Get() == Body; });
+		}
+
+		struct FSqueezedCube
+		{
+			UStaticMeshComponent* Target = nullptr;
+			UStaticMeshComponent* Glass = nullptr;
+			UStaticMeshComponent* Neighbour = nullptr;
+
+			explicit FSqueezedCube(FBeamTestWorld& TestWorld)
+			{
+				Target = TestWorld.SpawnCube(TargetLocation, FVector::OneVector, TEXT("Scalable"), true);
+
+				// Level glass does not generate overlap events
+				Glass = TestWorld.SpawnCube(TargetLocation + FVector(0.0f, BlockerDistance, 0.0f), FVector(3.0f, 0.2f, 3.0f), TEXT("Glass"), false);
+				if (Glass != nullptr)
+				{
+					Glass->SetGenerateOverlapEvents(false);
+				}
+
+				Neighbour = TestWorld.SpawnCube(TargetLocation - FVector(0.0f, BlockerDistance, 0.0f), FVector(3.0f, 0.2f, 3.0f), TEXT("Scalable"), false);
+			}
+
+			bool IsValid() const { return Target != nullptr && Glass != nullptr && Neighbour != nullptr; }
+		};
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBeamProximityShellBlockersTest, "Diminuator.Beam.ProximityShell.GlassAndScalableBlockers", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBeamProximityShellBlockersTest::RunTest(const FString& Parameters)
+{
+	using namespace BeamProximityShellTest;
+
+	FBeamTestWorld testWorld;
+	FSqueezedCube scene(testWorld);
+	if (!TestTrue(TEXT("Scene spawned"), scene.IsValid()))
+	{
+		return false;
+	}
+
+	UBeamProximityShell* shell = NewObject<UBeamProximityShell>(scene.Target->GetOwner());
+	shell->RegisterComponent();
+	shell->Track(scene.Target, BlockerDistance);
+
+	const TArray<TWeakObjectPtr<UPrimitiveComponent>>& nearby = shell->GetNearbyBodies();
+	const TArray<TWeakObjectPtr<UPrimitiveComponent>>& statics = shell->GetStaticBodies();
+	TestTrue(TEXT("Glass wall found"), Contains(nearby, scene.Glass) || Contains(statics, scene.Glass));
+	TestTrue(TEXT("Scalable neighbour found"), Contains(nearby, scene.Neighbour) || Contains(statics, scene.Neighbour));
+
+	shell->StopTracking();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBeamGrowTowardBlockersTest, "Diminuator.Beam.ProximityShell.GrowTowardGlassAndScalable", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FBeamGrowTowardBlockersTest::RunTest(const FString& Parameters)
+{
+	using namespace BeamProximityShellTest;
+
+	FBeamTestWorld testWorld;
+	ADiminuatorCharacter* character = testWorld.SpawnPlayer();
+	FSqueezedCube scene(testWorld);
+	if (!TestNotNull(TEXT("Character"), character) || !TestNotNull(TEXT("Beam"), character->GetBeamComponent()) || !TestTrue(TEXT("Scene spawned"), scene.IsValid()))
+	{
+		return false;
+	}
+	UBeamComponent* beam = character->GetBeamComponent();
+	beam->BeamRange = 1000.0f;
+	beam->bProximityShell = true;
+
+	beam->AimPoseSource.BindLambda([](FBeamAimPose& OutPose)
+	{
+		OutPose.Location = FVector(0.0f, 0.0f, TargetLocation.Z);
+		OutPose.Rotation = FRotator::ZeroRotator;
+		OutPose.SampleTime = FPlatformTime::Seconds();
+		return true;
+	});
+
+	// Long enough to grow far past the gap in open space
+	beam->OnStartFire(BeamMode::AUGMENTATOR);
+	for (int32 i = 0; i < 120; ++i)
+	{
+		testWorld.Tick();
+	}
+	beam->OnStopFire(BeamMode::AUGMENTATOR);
+	testWorld.Tick();
+
+	const float halfSize = scene.Target->GetComponentScale().Y * 50.0f;
+	TestTrue(TEXT("Cube grew"), halfSize > 50.0f);
+	TestTrue(FString::Printf(TEXT("Cube stopped at the blockers (half size %.1f, gap %.1f)"), halfSize, GrowthGap), halfSize <= GrowthGap + GrowthTolerance);
+
+	return true;
+}
+
+#endif
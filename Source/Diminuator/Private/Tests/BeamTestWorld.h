@@ -0,0 +1,82 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "DiminuatorCharacter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/*
+* Empty standalone game world for the beam automation tests, destroyed with the test.
+* Ticked by hand, the late update runs after the actors like in a real frame.
+*/
+class FBeamTestWorld
+{
+public:
+
+	FBeamTestWorld()
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("BeamTestWorld"));
+		FWorldContext& context = GEngine->CreateNewWorldContext(EWorldType::Game);
+		context.SetCurrentWorld(World);
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+	}
+
+	~FBeamTestWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	/* Character possessed by a local player, so the beam aims and draws on this machine */
+	ADiminuatorCharacter* SpawnPlayer()
+	{
+		ADiminuatorCharacter* character = World->SpawnActor<ADiminuatorCharacter>(FVector::ZeroVector, FRotator::ZeroRotator);
+		APlayerController* controller = World->SpawnActor<APlayerController>();
+		if (character != nullptr && controller != nullptr)
+		{
+			controller->Possess(character);
+		}
+		return character;
+	}
+
+	/* Engine cube, 100 units wide. Simulated ones float, gravity off */
+	UStaticMeshComponent* SpawnCube(const FVector& Location, const FVector& Scale, FName CollisionProfile, bool bSimulate)
+	{
+		UStaticMesh* cubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+		AStaticMeshActor* cube = World->SpawnActor<AStaticMeshActor>(Location, FRotator::ZeroRotator);
+		if (cubeMesh == nullptr || cube == nullptr)
+		{
+			return nullptr;
+		}
+
+		UStaticMeshComponent* component = cube->GetStaticMeshComponent();
+		component->SetMobility(EComponentMobility::Movable);
+		component->SetStaticMesh(cubeMesh);
+		component->SetWorldScale3D(Scale);
+		component->SetCollisionProfileName(CollisionProfile);
+		component->SetEnableGravity(false);
+		component->SetSimulatePhysics(bSimulate);
+		return component;
+	}
+
+	void Tick(float DeltaTime = 1.0f / 60.0f)
+	{
+		World->Tick(LEVELTICK_All, DeltaTime);
+	}
+
+	UWorld* GetWorld() const { return World; }
+
+private:
+
+	UWorld* World;
+};
+
+#endif
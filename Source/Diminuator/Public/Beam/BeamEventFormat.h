@@ -0,0 +1,71 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Beam event log file layout: FBeamEventFileHeader followed by blocks.
+* Each block is an FBeamEventBlockHeader and its payload:
+*	Names	Count entries of { uint32 NameId, uint16 Length, UTF8 chars }, every name
+*			referenced by the event blocks after it, written once per file
+*	Events	Count FBeamEventRecord
+* Little endian, no padding.
+*/
+
+#define BEAM_EVENT_MAGIC	0x54564542	// "BEVT"
+#define BEAM_EVENT_VERSION	1
+
+enum class EBeamEventType : uint8
+{
+	StateChange,		// State = new mode, Arg = previous mode
+	Grab,				// Value = grab distance
+	Release,
+	StuckTimerStart,	// Value = disconnection time
+	StuckTimerFire,
+	ScaleBlocked,		// Value = current scale
+	ProjectileImpact,	// Value = impulse
+	Dropped,			// Written by the log itself, Value = records lost because the ring was full
+
+	Count
+};
+
+enum class EBeamEventBlock : uint32
+{
+	Names = 1,
+	Events = 2,
+};
+
+struct FBeamEventFileHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint32 RecordSize;
+	uint32 FileIndex;
+	int64 StartUtcTicks;	// FDateTime ticks when the log started, record times are relative to it
+	uint32 Reserved[2];
+};
+
+struct FBeamEventBlockHeader
+{
+	uint32 Type;
+	uint32 Count;
+};
+
+struct FBeamEventRecord
+{
+	double Time;			// seconds since the log started
+	uint32 Frame;
+	uint32 ThreadId;
+	uint8 Type;
+	uint8 State;
+	uint8 Arg;
+	uint8 Pad;
+	uint32 SourceId;		// UObject unique id of the beam owner or projectile instigator
+	uint32 TargetNameId;	// target actor name, see the Names blocks
+	int32 TargetNameNumber;
+	float Location[3];
+	float Value;
+};
+
+static_assert(sizeof(FBeamEventFileHeader) == 32, "Beam event file header layout changed, bump BEAM_EVENT_VERSION");
+static_assert(sizeof(FBeamEventRecord) == 48, "Beam event record layout changed, bump BEAM_EVENT_VERSION");
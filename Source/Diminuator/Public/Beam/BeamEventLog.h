@@ -0,0 +1,86 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Misc/DateTime.h"
+#include "Beam/BeamEventFormat.h"
+#include "Beam/BeamEventRing.h"
+
+class AActor;
+class FRunnableThread;
+class FArchive;
+
+/*
+* Always on beam event log for post-mortem analysis.
+* Record copies a 48 byte record into a preallocated lock-free ring and returns, any thread
+* can record. A background thread drains the ring to Saved/BeamEvents, rotating files by size.
+* Records are dropped, and counted, if the writer ever falls a whole ring behind.
+* Convert the files with -run=BeamEventLog.
+*/
+class DIMINUATOR_API FBeamEventLog : public FRunnable
+{
+public:
+
+	static void Startup();
+	static void Shutdown();
+
+	static FORCEINLINE void Record(EBeamEventType Type, const UObject* Source, const AActor* Target, const FVector& Location, float Value = 0.0f, uint8 State = 0, uint8 Arg = 0)
+	{
+		// Counted while inside so Shutdown does not delete the log under a late recorder.
+		// Sequentially consistent with the null store in Shutdown, either sees the other
+		ActiveRecorders.fetch_add(1);
+		FBeamEventLog* log = Instance.load();
+		if (log != nullptr)
+		{
+			log->Push(Type, Source, Target, Location, Value, State, Arg);
+		}
+		ActiveRecorders.fetch_sub(1, std::memory_order_release);
+	}
+
+	// FRunnable interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	// End of FRunnable interface
+
+private:
+
+	FBeamEventLog();
+	virtual ~FBeamEventLog();
+
+	void Push(EBeamEventType Type, const UObject* Source, const AActor* Target, const FVector& Location, float Value, uint8 State, uint8 Arg);
+
+	/* Writes everything in the ring, returns the number of records written */
+	int32 Drain();
+
+	void WriteBatch();
+
+	bool OpenFile();
+
+	void CloseFile();
+
+	void DeleteOldFiles();
+
+	static std::atomic<FBeamEventLog*> Instance;
+
+	// Record calls in progress on any thread
+	static std::atomic<int32> ActiveRecorders;
+
+	// 16K records, about 1MB, several seconds of worst case traffic
+	TBeamEventRing<FBeamEventRecord, 16384> Ring;
+	std::atomic<uint64> DroppedRecords;
+	double StartSeconds;
+	FDateTime StartUtc;
+
+	FRunnableThread* Thread;
+	std::atomic<bool> bStopping;
+
+	// Writer thread only
+	TArray<FBeamEventRecord> Batch;
+	TSet<uint32> WrittenNames;
+	TArray<uint8> NameBlock;
+	TUniquePtr<FArchive> File;
+	FString BaseFileName;
+	uint32 FileIndex;
+	uint64 ReportedDropped;
+};
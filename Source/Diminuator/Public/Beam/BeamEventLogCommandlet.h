@@ -0,0 +1,36 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Misc/DateTime.h"
+#include "Beam/BeamEventFormat.h"
+
+#include "BeamEventLogCommandlet.generated.h"
+
+/*
+* Converts beam event log files to CSV or JSON.
+*
+* UE4Editor-Cmd Diminuator.uproject -run=BeamEventLog -In=BeamEvents_2020.01.01-00.00.00_000.bevt -Format=json
+*	-In			log file, or a directory to convert all its logs in order; relative paths go to Saved/BeamEvents
+*	-Out		output file (default: input file with the format extension)
+*	-Format		csv or json (default csv)
+*/
+UCLASS()
+class UBeamEventLogCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UBeamEventLogCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+
+	/* Appends one line per event of a log file, false if the file is not a valid log */
+	bool ConvertFile(const FString& FileName, bool bJson, TArray<FString>& OutLines) const;
+
+	static FString FormatEvent(const FBeamEventRecord& Record, const FDateTime& StartUtc, const TMap<uint32, FString>& Names, bool bJson);
+};
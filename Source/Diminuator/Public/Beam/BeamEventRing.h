@@ -0,0 +1,113 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/*
+* Bounded lock-free multi producer multi consumer queue (Vyukov's sequenced ring).
+* Every cell carries a sequence number telling whether it is free for the producer
+* at that position or filled for the consumer, so producers and consumers only contend
+* on their own position counter. Push fails instead of waiting when the ring is full.
+*/
+template<typename ElementType, uint32 Capacity>
+class TBeamEventRing
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Ring capacity must be a power of two");
+
+public:
+
+	TBeamEventRing()
+	{
+		for (uint32 i = 0; i < Capacity; ++i)
+		{
+			Cells[i].Sequence.store(i, std::memory_order_relaxed);
+		}
+		EnqueuePos.store(0, std::memory_order_relaxed);
+		DequeuePos.store(0, std::memory_order_relaxed);
+	}
+
+	/* False when the ring is full, the element is not queued */
+	bool TryPush(const ElementType& Element)
+	{
+		FCell* cell;
+		uint64 pos = EnqueuePos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			cell = &Cells[pos & Mask];
+			const uint64 sequence = cell->Sequence.load(std::memory_order_acquire);
+			const int64 diff = static_cast<int64>(sequence) - static_cast<int64>(pos);
+			if (diff == 0)
+			{
+				// Free cell at our position, claim it
+				if (EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				// Consumer has not freed this cell yet, full
+				return false;
+			}
+			else
+			{
+				// Another producer claimed it, retry at the new position
+				pos = EnqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->Element = Element;
+		cell->Sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* False when the ring is empty */
+	bool TryPop(ElementType& OutElement)
+	{
+		FCell* cell;
+		uint64 pos = DequeuePos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			cell = &Cells[pos & Mask];
+			const uint64 sequence = cell->Sequence.load(std::memory_order_acquire);
+			const int64 diff = static_cast<int64>(sequence) - static_cast<int64>(pos + 1);
+			if (diff == 0)
+			{
+				if (DequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				// Producer has not filled this cell yet, empty
+				return false;
+			}
+			else
+			{
+				pos = DequeuePos.load(std::memory_order_relaxed);
+			}
+		}
+
+		OutElement = cell->Element;
+		// Free for the producer one lap ahead
+		cell->Sequence.store(pos + Mask + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+
+	static constexpr uint64 Mask = Capacity - 1;
+
+	struct FCell
+	{
+		std::atomic<uint64> Sequence;
+		ElementType Element;
+	};
+
+	// Positions on their own cache lines, producers and consumer do not false share
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> EnqueuePos;
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> DequeuePos;
+	alignas(PLATFORM_CACHE_LINE_SIZE) FCell Cells[Capacity];
+};
@@ -0,0 +1,129 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "CollisionQueryParams.h"
+#include "WorldCollision.h"
+
+class UWorld;
+class UPrimitiveComponent;
+
+#define BEAM_PATH_MAX_SEGMENTS 4
+
+/*
+* Straight piece of the beam, one multi hit trace each
+*/
+struct FBeamSegment
+{
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+
+	// Scene queries spent on this segment
+	int32 QueryCount = 0;
+
+	// Glass panes the segment went through
+	int32 GlassCount = 0;
+
+	float GetLength() const { return (End - Start).Size(); }
+};
+
+/*
+* Beam path from the muzzle to the final target, through glass and bouncing off reflective surfaces
+*/
+struct DIMINUATOR_API FBeamPath
+{
+	TArray<FBeamSegment, TInlineAllocator<BEAM_PATH_MAX_SEGMENTS>> Segments;
+
+	// Blocking hit at the end of the path, only valid if bHit
+	FHitResult TargetHit;
+	bool bHit = false;
+
+	// Distance along the path to the target hit
+	float TargetDistance = 0.0f;
+
+	// Total length of all segments
+	float Length = 0.0f;
+
+	// Query budget ran out before the path was complete
+	bool bTruncated = false;
+
+	// Frames since the path was traced, 0 if traced this frame
+	int32 Age = 0;
+
+	// Reused from the tracer cache, no scene query was made
+	bool bCached = false;
+
+	void Reset();
+
+	/* Point at distance along the path, extrapolates along the last segment */
+	FVector GetPointAtDistance(float Distance) const;
+
+	/* Distance along the path to a point near the last segment */
+	float GetDistanceTo(const FVector& Point) const;
+};
+
+/*
+* Traces beam paths through the query scheduler budget,
+* and reuses the last path while nothing on it moved and nothing moved into it.
+* Movable bodies near a traced path are gathered once, a cached path only checks where they are now.
+*/
+class DIMINUATOR_API FBeamPathTracer
+{
+public:
+
+	FBeamPathTracer();
+
+	bool Trace(UWorld* World, const FVector& Start, const FVector& Direction, float Range, const FCollisionQueryParams& Params, FBeamPath& OutPath);
+
+	/* Forget the cached path, next trace will query the scene */
+	void Invalidate();
+
+	/* Segments including bounces, clamped to BEAM_PATH_MAX_SEGMENTS */
+	int32 MaxSegments;
+
+	/* Actors or components with this tag bounce the beam */
+	FName ReflectiveTag;
+
+	/* Frames a cached path is trusted before tracing again even if nothing on it moved */
+	int32 CacheMaxFrames;
+
+	/*
+	* Distance around the path where movable bodies are watched while it is cached.
+	* Bodies farther away, or spawned meanwhile, are seen on the next trace, at most CacheMaxFrames later.
+	*/
+	float CacheWatchDistance;
+
+protected:
+
+	bool IsCacheValid(UWorld* World, const FVector& Start, const FVector& Direction, float Range);
+
+	/* True if a watched body moved and its bounds now cross a cached segment */
+	bool HasIntrusion() const;
+
+	/* Movable bodies the trace would see near the path, false when over the query budget */
+	bool GatherWatchedComponents(UWorld* World, const FCollisionQueryParams& Params, const FBeamPath& Path);
+
+	void StoreCache(UWorld* World, const FVector& Start, const FVector& Direction, float Range, const FBeamPath& Path);
+
+	bool IsReflective(const FHitResult& Hit) const;
+
+	// Cached path and what it was traced from
+	FBeamPath CachedPath;
+	FVector CachedStart;
+	FVector CachedDirection;
+	float CachedRange;
+	uint64 CachedFrame;
+	TWeakObjectPtr<UWorld> CachedWorld;
+	TArray<TPair<TWeakObjectPtr<UPrimitiveComponent>, FTransform>, TInlineAllocator<8>> CachedComponents;
+
+	TArray<TPair<TWeakObjectPtr<UPrimitiveComponent>, FTransform>, TInlineAllocator<16>> WatchedComponents;
+
+	// Components touched by the trace in progress, and the movable ones near it
+	TArray<TPair<TWeakObjectPtr<UPrimitiveComponent>, FTransform>, TInlineAllocator<8>> TracedComponents;
+	TArray<TPair<TWeakObjectPtr<UPrimitiveComponent>, FTransform>, TInlineAllocator<16>> NearbyComponents;
+
+	// Reused multi hit and overlap results
+	TArray<FHitResult> ScratchHits;
+	TArray<FOverlapResult> ScratchOverlaps;
+};
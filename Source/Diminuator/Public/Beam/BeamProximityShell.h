@@ -0,0 +1,68 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/BoxComponent.h"
+#include "WorldCollision.h"
+
+#include "BeamProximityShell.generated.h"
+
+/*
+* Query only box around the beamed object that keeps the bodies near it from overlap events,
+* so scale up clearance only probes when and where something is around.
+* Level geometry usually has overlap events off, world static, glass and scalable bodies come
+* from an overlap query too, repeated only once the target moved out of the slack the inflation leaves.
+* Only bodies that block the clearance probes are kept.
+*/
+UCLASS()
+class DIMINUATOR_API UBeamProximityShell : public UBoxComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UBeamProximityShell();
+
+	/*
+	* Follows NewTarget, HalfExtent must cover the clearance probes. While it stays on the same
+	* target the box only grows, to Inflation times the extent asked so it does not resize every tick.
+	*/
+	void Track(UPrimitiveComponent* NewTarget, float HalfExtent);
+
+	/* Detaches and stops overlapping */
+	void StopTracking();
+
+	UPrimitiveComponent* GetTarget() const { return Target.Get(); }
+
+	const TArray<TWeakObjectPtr<UPrimitiveComponent>>& GetNearbyBodies() const { return NearbyBodies; }
+
+	const TArray<TWeakObjectPtr<UPrimitiveComponent>>& GetStaticBodies() const { return StaticBodies; }
+
+	/* Shell extent over the extent asked to Track */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Beam, meta = (ClampMin = "1.0"))
+	float Inflation;
+
+protected:
+
+	/* Queries world static bodies around the shell, unless the last query still covers the probes */
+	void UpdateStaticBodies(bool bForce);
+
+	/* Same filter as the clearance probes: the scaled actor is ignored and only blocking bodies stop them */
+	bool IsProbeBlocker(const UPrimitiveComponent* Component) const;
+
+	UFUNCTION()
+	void OnShellBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	UFUNCTION()
+	void OnShellEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+
+	TWeakObjectPtr<UPrimitiveComponent> Target;
+
+	// Bodies overlapping the shell, a few at most
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> NearbyBodies;
+
+	// World static, glass and scalable bodies from the last query, overlap events or not
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> StaticBodies;
+	FVector StaticQueryLocation;
+	TArray<FOverlapResult> ScratchOverlaps;
+};
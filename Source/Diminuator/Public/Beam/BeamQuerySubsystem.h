@@ -0,0 +1,96 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Engine/EngineTypes.h"
+#include "CollisionQueryParams.h"
+#include "WorldCollision.h"
+
+#include "BeamQuerySubsystem.generated.h"
+
+/*
+* Deferred line trace. Owner keeps it alive and reads the result when it is ready.
+*/
+struct DIMINUATOR_API FBeamQuery
+{
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	ECollisionChannel Channel = ECC_WorldStatic;
+	TWeakObjectPtr<const AActor> IgnoredActor;
+
+	// Result of the last run
+	bool bHit = false;
+	bool bHasResult = false;
+	uint64 CompletedFrame = 0;
+
+	// Waiting in the scheduler queue
+	bool bPending = false;
+
+	/* Frames since the result was computed, results never computed are infinitely old */
+	int32 GetAge() const { return bHasResult ? static_cast<int32>(GFrameCounter - CompletedFrame) : MAX_int32; }
+
+	void Invalidate() { bHasResult = false; }
+};
+
+/*
+* Frame budgeted scene query scheduler shared by every beam.
+* Aim traces are charged to the frame budget first, queued queries run at the end of
+* the frame with whatever is left and spill over to next frames under load.
+*/
+UCLASS()
+class DIMINUATOR_API UBeamQuerySubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	static UBeamQuerySubsystem* Get(const UWorld* World);
+
+	/*
+	* Aim multi line trace, runs now if the frame query count and time budgets allow it.
+	* Returns false when over budget, bOutBlock tells if there was a blocking hit.
+	*/
+	bool AimTraceMulti(TArray<FHitResult>& OutHits, const FVector& Start, const FVector& End, ECollisionChannel Channel, const FCollisionQueryParams& Params, bool& bOutBlock);
+
+	/* Aim overlap by object type, same budget as the aim traces. Returns false when over budget */
+	bool AimOverlapMulti(TArray<FOverlapResult>& OutOverlaps, const FVector& Position, const FQuat& Rotation, const FCollisionObjectQueryParams& ObjectParams, const FCollisionShape& Shape, const FCollisionQueryParams& Params);
+
+	/* Queue a query, ignored if it is already waiting */
+	void Enqueue(const TSharedRef<FBeamQuery>& Query);
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+	// End of FTickableGameObject interface
+
+protected:
+
+	/* Starts a new frame budget when the frame changes */
+	void UpdateFrameBudget();
+
+	bool HasBudget() const;
+
+	/* Budget check for the immediate aim queries, counts the ones refused */
+	bool HasAimBudget() const;
+
+	/* Charges an immediate query to the frame budget */
+	void ChargeAimQuery(double Elapsed);
+
+	void RunQuery(FBeamQuery& Query);
+
+	// Queued queries, FIFO
+	TArray<TSharedRef<FBeamQuery>> PendingQueries;
+
+	// Reused by every queued query
+	FCollisionQueryParams QueryParams = FCollisionQueryParams(TEXT("BeamQuery"), false);
+	FHitResult ScratchHit;
+
+	// Budget used this frame
+	uint64 BudgetFrame = 0;
+	int32 QueriesThisFrame = 0;
+	double QuerySecondsThisFrame = 0.0;
+};
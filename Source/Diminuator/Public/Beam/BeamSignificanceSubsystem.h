@@ -0,0 +1,75 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "BeamSignificanceSubsystem.generated.h"
+
+class UBeamComponent;
+
+/*
+* How much a beam matters to the local viewers
+*/
+UENUM()
+enum class EBeamSignificance : uint8
+{
+	High,		// Full rate and effects
+	Medium,		// Reduced cosmetic tick rate
+	Low,		// Lowest cosmetic tick rate and no effects
+	Count		UMETA(Hidden),
+};
+
+/*
+* Ranks every beam by distance and visibility to the local viewers (split screen players
+* included) and sets its significance. Lower tiers only cost visuals: beams simulated on this
+* machine (authority or locally controlled) keep their full tick rate and clearance, cosmetic
+* beams tick less often. Worlds without local viewers, like dedicated servers, keep every
+* beam at full fidelity.
+*/
+UCLASS()
+class DIMINUATOR_API UBeamSignificanceSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	static UBeamSignificanceSubsystem* Get(const UWorld* World);
+
+	void RegisterBeam(UBeamComponent* Beam);
+	void UnregisterBeam(UBeamComponent* Beam);
+
+	/* Game thread cycles of a cosmetic beam tick at its tier, used to estimate the time lower tiers save */
+	void RecordCosmeticTick(EBeamSignificance Significance, uint64 Cycles);
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+	// End of FTickableGameObject interface
+
+protected:
+
+	struct FViewer
+	{
+		FVector Location;
+		FVector Direction;
+		float CosHalfFOV;
+		const AActor* Pawn;
+	};
+
+	/* Local player views, empty when nobody plays on this machine */
+	void GatherViewers(TArray<FViewer, TInlineAllocator<4>>& OutViewers) const;
+
+	EBeamSignificance Evaluate(const UBeamComponent* Beam, const TArray<FViewer, TInlineAllocator<4>>& Viewers) const;
+
+	TArray<TWeakObjectPtr<UBeamComponent>> Beams;
+
+	// Ranking runs a few times per second, tiers do not need to follow every frame
+	float UpdateTimer = 0.0f;
+
+	// Average cosmetic beam tick per tier, beams simulated on this machine never slow down
+	double CosmeticTickMs[static_cast<int32>(EBeamSignificance::Count)] = {};
+};
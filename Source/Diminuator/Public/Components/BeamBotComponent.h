@@ -0,0 +1,112 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "BeamBotComponent.generated.h"
+
+class ADiminuatorCharacter;
+
+/*
+* What the bot is doing, picked at random with the action weights
+*/
+enum class EBeamBotAction : uint8
+{
+	Wander,
+	Diminuate,
+	Augment,
+	GrabCombo,
+	FireVolley,
+};
+
+/*
+* Headless load test player. Drives the character input like a player would:
+* walks to physics objects, scales them with either beam, grabs and drags them
+* with both triggers and fires projectile volleys. Added on clients run with -BeamBot,
+* -BeamBotSeed=<n> makes a bot repeat the same session.
+*/
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent), Within = DiminuatorCharacter)
+class DIMINUATOR_API UBeamBotComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UBeamBotComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	void StartAction();
+
+	void EndAction();
+
+	void UpdateAction(float DeltaTime);
+
+	/* Random physics object around the bot, null if there is none */
+	AActor* FindTarget() const;
+
+	/* Turns towards the target, or the wander direction, and walks until in beam range */
+	void Steer(float DeltaTime, bool bApproach);
+
+public:
+
+	/* Relative chance of each action */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float WanderWeight;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float DiminuateWeight;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float AugmentWeight;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float GrabComboWeight;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float FireVolleyWeight;
+
+	/* Action duration range, in seconds */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float MinActionTime;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float MaxActionTime;
+
+	/* Radius to look for physics objects to beam */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float TargetSearchRadius;
+
+	/* Seconds between shots in a volley */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float FireInterval;
+
+	/* Aim interpolation speed, lower is a sloppier player */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float AimSpeed;
+
+protected:
+
+	ADiminuatorCharacter* Character;
+
+	FRandomStream Random;
+
+	EBeamBotAction Action;
+	float ActionTime;
+	float ActionTimer;
+
+	// Combo step or shots fired, depending on the action
+	int32 ActionStep;
+	float StepTimer;
+
+	TWeakObjectPtr<AActor> Target;
+	float WanderYaw;
+	float AimWobblePhase;
+};
@@ -4,12 +4,24 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "DiminuatorTypes.h"
+#include "Beam/BeamPath.h"
+#include "Beam/BeamQuerySubsystem.h"
+#include "Beam/BeamSignificanceSubsystem.h"
+#include "BeamRules.h"
 
 #include "BeamComponent.generated.h"
 
 class ADiminuatorCharacter;
 class UPrimitiveComponent;
 class UPhysicsHandleComponent;
+class UStaticMeshComponent;
+class UBeamProximityShell;
+struct FBeamPresentedPoseAge;
+
+/*
+* External aim source (e.g. a simulated controller). Returns false to fall back to the character aim.
+*/
+DECLARE_DELEGATE_RetVal_OneParam(bool, FBeamAimPoseSource, FBeamAimPose& /*OutPose*/);
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent), Within = DiminuatorCharacter)
 class DIMINUATOR_API UBeamComponent : public UActorComponent
@@ -24,33 +36,94 @@ public:
 	// Called every frame checks beam state
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 	// Fire beam event
 	void OnStartFire(BeamMode Mode);
 
 	// Stop beam event
 	void OnStopFire(BeamMode Mode);
 
+	bool IsBeamActive() const;
+
+	/* Holding an object with the physics handle */
+	bool IsGrabbing() const;
+
+	/*
+	* Set by the significance subsystem. Lower tiers draw fewer effects, and cosmetic beams
+	* also tick less often. Beams simulated here keep the full tick rate and clearance.
+	*/
+	void SetSignificance(EBeamSignificance NewSignificance, float TickInterval);
+	EBeamSignificance GetSignificance() const { return Significance; }
+
+	/* This machine runs the beam simulation: the authority, or the player holding it */
+	bool IsSimulationOwner() const;
+
 protected:
 
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
-	// Executed when beam is active
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/*
+	* Executed when beam is active. The authority runs the whole beam, other machines
+	* only trace and draw it: the owning client with its own aim, the rest with the replicated one.
+	*/
 	void ShootBeam(float DeltaTime);
 
-	void BeamPhysicsLogic(float DeltaTime);
+	/* Aim of the player holding the beam, sent while it fires */
+	UFUNCTION(Server, Unreliable)
+	void ServerSetAimPose(const FBeamAimPose& Pose);
+
+	UFUNCTION()
+	void OnRep_BeamState();
 
-	void BeamStaticLogic(float HitDistance);
+	UFUNCTION()
+	void OnRep_RemoteAimPose();
+
+	/*
+	* Muzzle pose used for aiming. In VR it comes from the right motion controller,
+	* bLatest polls the tracking system directly instead of using the component transform.
+	* Players on other machines aim with the pose they sent.
+	*/
+	bool SampleAimPose(FBeamAimPose& OutPose, bool bLatest) const;
+
+	bool PollMotionControllerTransform(FTransform& OutTransform) const;
+
+	/*
+	* Late update: runs after all actors ticked, right before render.
+	* Re-samples the aim pose and corrects the beam end point with it.
+	*/
+	void LateUpdateBeam(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/* Every beam.LatencySampleFrames, times the drawn pose when its frame reaches the RHI thread. Reads back the last one measured */
+	void MeasureMotionToBeamLatency(double SampleTime);
+
+	void BeamPhysicsLogic(float DeltaTime);
 
 	void TryReleaseObject();
 
-	void BeamEffects(const FVector start, const FVector end);
+	/* Listens to the contacts of the grabbed component, the previous one stops being tracked */
+	void StartStuckTracking(UPrimitiveComponent* Component);
+	void StopStuckTracking();
+
+	/* Releases the grabbed object when a contact keeps it from following the handle for DisconnectionTime */
+	void UpdateStuckDetection(float DeltaTime);
+
+	UFUNCTION()
+	void OnGrabbedHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
+	/* Draws the beam path up to BeamLength, moved by the late update correction */
+	void BeamEffects(const FTransform& Correction);
 
 	/*
-	* Check collisions for each cube vertex so we can prevent scaling
+	* Check collisions for each cube vertex so we can prevent scaling.
+	* Probes and the blocking rule come from BeamCore, they run through the query scheduler
+	* and results too old or missing count as blocked. With bProximityShell only the faces
+	* with a body near are probed, and none at all in open space.
 	*/
 	bool CheckScaleCollisions(UPrimitiveComponent* Component);
-	bool CheckVertexCollisions(UPrimitiveComponent* Component, const FVector Direction, const FVector Vertex);
 	
 	/* 
 	* Changes beam state machine depending on user inputs.
@@ -60,16 +133,36 @@ protected:
 
 	/*
 	* Important!
-	* Only scale if scaling up and collisions are clear or if scaling down and not min size reached
+	* Only scale if scaling up and collisions are clear or if scaling down and not min size reached.
+	* Scalable objects use their own min and max scale, anything else MinSize.
+	*/
+	bool CheckScalingConditions(FVector currentScale3D, FVector newScale3D);
+
+	/* Scalable object of the component, cached for the last component asked */
+	UObject* GetScalable(UPrimitiveComponent* Component);
+
+	/* Registered in the Scalable channel, implements IScalable or simulates physics */
+	bool IsScalable(UPrimitiveComponent* Component);
+
+	/* Physics body of Component got a new scale, lets the scalable object adjust its mass */
+	void NotifyScaleCommitted(UPrimitiveComponent* Component, const FVector& NewScale);
+
+	/*
+	* Render only scale preview. The visible mesh follows the beam every frame,
+	* the physics body gets the new scale every ScaleCommitInterval, when its half extent is
+	* ScaleCommitDistance away from the visible one or when the beam leaves the component.
 	*/
-	bool CheckScalingConditions(FVector newScale3D);
+	void UpdateScalePreview(UPrimitiveComponent* Component, const FVector& NewScale);
+	void CommitScale();
+	void EndScalePreview();
+
+	/* Scale the player sees, the preview one while scaling */
+	FVector GetVisualScale(UPrimitiveComponent* Component) const;
 
 	FColor GetBeamColor(BeamMode Mode);
 
 	float GetBeamScale(BeamMode Mode);
 
-	bool IsBeamActive();
-
 public:
 
 	/* Beam line trace range */
@@ -100,24 +193,117 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
 	float DisconnectionTime;
 
+	/* Distance from the handle target at which a blocked grabbed object is not following the beam */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay, meta = (ClampMin = "0.0"))
+	float StuckTrackingError;
+
 	/* Min scaling size */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
 	float MinSize;
 
+	/* Half extent change, in world units, that rebuilds the collision of the scaled component right away */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay, meta = (ClampMin = "0.0"))
+	float ScaleCommitDistance;
+
+	/* Seconds between collision rebuilds while scaling, also how often clients get the new scale */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay, meta = (ClampMin = "0.0"))
+	float ScaleCommitInterval;
+
+	/* Only probe clearance toward the sides with bodies near, from the overlaps of a shell around the scaled object */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
+	bool bProximityShell;
+
+	/* Frames a clearance probe result is trusted, older results count as blocked */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay, meta = (ClampMin = "0"))
+	int32 MaxClearanceAge;
+
+	/* Beam segments through glass and reflective bounces, the last one reaches the target */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay, meta = (ClampMin = "1", ClampMax = "4"))
+	int32 MaxBeamSegments;
+
+	/* Correct the beam end point with the latest controller pose just before render */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = VR)
+	bool bLateUpdate;
+
+	/* Overrides the aim pose, used to drive the beam without headset hardware */
+	FBeamAimPoseSource AimPoseSource;
+
+	/*
+	* Time between the sample of the drawn aim pose and the RHI thread submitting its frame, in seconds.
+	* Measured on the render side every few frames, so it lags the beam a frame or more.
+	*/
+	float GetMotionToBeamLatency() const { return MotionToBeamLatency; }
+
 protected:
 
-	// Beam state machine
-	BeamMode BeamState;
+	// Beam state machine, the owning client runs its own from the same inputs
+	UPROPERTY(ReplicatedUsing = OnRep_BeamState)
+	TEnumAsByte<BeamMode> BeamState;
+
+	// Aim of a player on another machine, SampleTime is when it arrived
+	UPROPERTY(ReplicatedUsing = OnRep_RemoteAimPose)
+	FBeamAimPose RemoteAimPose;
+
+	// Last aim sent to the server, unchanged poses are not sent again
+	FBeamAimPose SentAimPose;
+
+	// Visual fidelity, see SetSignificance
+	EBeamSignificance Significance;
+	UBeamSignificanceSubsystem* SignificanceSubsystem;
 
 	// Line trace results
 	ADiminuatorCharacter* Character;
 	UPrimitiveComponent* HitComponent;
 	FVector Start;
 	float GrabDistance;
+
+	// Aim pose used by the last trace and the resulting beam length
+	FBeamAimPose AimPose;
+	float BeamLength;
+
+	// Path from the muzzle to the target
+	FBeamPathTracer PathTracer;
+	FBeamPath BeamPath;
+
+	// Aim trace parameters, built on begin play
+	FCollisionQueryParams AimQueryParams;
+
+	// Beam effect waiting for the late update
+	bool bBeamPending;
+	FDelegateHandle LateUpdateHandle;
+	float MotionToBeamLatency;
+	TSharedPtr<FBeamPresentedPoseAge, ESPMode::ThreadSafe> PresentedPoseAge;
+	int32 LatencySampleCountdown;
 	
+	// Scale up clearance probes and the component they were shot for
+	TArray<TSharedRef<FBeamQuery>> ClearanceQueries;
+	TWeakObjectPtr<UPrimitiveComponent> ClearanceTarget;
+	bool bClearanceSphere;
+
+	// Bodies near the scaled component, created once and moved from target to target
+	UPROPERTY(Transient)
+	UBeamProximityShell* ProximityShell;
+
+	// Scalable lookup cache
+	TWeakObjectPtr<UPrimitiveComponent> ScalableComponent;
+	TWeakObjectPtr<UObject> Scalable;
+
+	// Scale preview, collision scale lags behind the visible one
+	UPROPERTY(Transient)
+	UStaticMeshComponent* PreviewComponent;
+	TWeakObjectPtr<UPrimitiveComponent> PreviewTarget;
+	FVector PreviewScale;
+	FVector CommittedScale;
+	float LastCommitTime;
+	// Physics state of the target before the preview, restored at the end
+	bool bPreviewTargetSimulated;
+
 	// Grabbing component
 	UPhysicsHandleComponent* PhysicsHandleComponent;
 
-	// Disconnetion handler
-	FTimerHandle StuckTimerHandle;
+	// Disconnection from the contacts of the grabbed component
+	BeamCore::FBeamStuckDetector StuckDetector;
+	TWeakObjectPtr<UPrimitiveComponent> StuckTrackedComponent;
+	bool bTrackedNotifiedCollision;
+	BeamCore::FBeamRecentContacts RecentContacts;
 };
@@ -0,0 +1,139 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/NetSerialization.h"
+#include "Interfaces/Scalable.h"
+
+#include "ScalableComponent.generated.h"
+
+/*
+* Makes its actor scalable by the beam. On begin play the root primitive is registered
+* in the Scalable object channel, so beam and area queries can look for scalable objects only.
+*
+* On the server it also replicates the scale and keeps the actor net dormant while its body
+* sleeps and no beam touches it. Beams, projectiles and physics wake ups bring it back, and
+* its net priority grows with beams nearby and recent scale changes. Clients blend to each
+* replicated scale over ScaleInterpTime instead of jumping between commits.
+*/
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class DIMINUATOR_API UScalableComponent : public UActorComponent, public IScalable
+{
+	GENERATED_BODY()
+
+public:
+
+	UScalableComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/* A beam shot from BeamStart is touching the object */
+	void NotifyBeamed(const FVector& BeamStart);
+
+	/* Leaves net dormancy, server only */
+	void WakeUp();
+
+	// IScalable interface
+	virtual float GetMinScale_Implementation() const override { return MinScale; }
+	virtual float GetMaxScale_Implementation() const override { return MaxScale; }
+	virtual EScalableMassPolicy GetMassPolicy_Implementation() const override { return MassPolicy; }
+	virtual EScalableClearanceShape GetClearanceShape_Implementation() const override { return ClearanceShape; }
+	virtual void OnScaleCommitted_Implementation(UPrimitiveComponent* Component, FVector NewScale) override;
+	// End of IScalable interface
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	UFUNCTION()
+	void OnRep_ReplicatedScale();
+
+	UFUNCTION()
+	void OnRootWake(UPrimitiveComponent* WakingComponent, FName BoneName);
+
+	void UpdateNetPriority(float Now);
+
+	void GoDormant();
+
+	/* Client blend toward ReplicatedScale, false once there */
+	bool UpdateScaleInterp(float DeltaTime);
+
+public:
+
+	/* Smallest uniform scale */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Scalable, meta = (ClampMin = "0.01"))
+	float MinScale;
+
+	/* Biggest uniform scale */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Scalable, meta = (ClampMin = "0.01"))
+	float MaxScale;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Scalable)
+	EScalableMassPolicy MassPolicy;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Scalable)
+	EScalableClearanceShape ClearanceShape;
+
+	/* Move the root primitive to the Scalable object channel on begin play */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Scalable)
+	bool bRegisterObjectChannel;
+
+	/* Net dormant while asleep and not beamed, the owner is set to replicate */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Replication)
+	bool bManageNetDormancy;
+
+	/* Seconds asleep and not beamed before going dormant */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Replication, meta = (ClampMin = "0.0"))
+	float DormancyDelay;
+
+	/* Owner net priority when nothing happens around it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Replication, meta = (ClampMin = "0.0"))
+	float BaseNetPriority;
+
+	/* Extra priority for a beam shot from right next to it, none at BeamPriorityDistance */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Replication, meta = (ClampMin = "0.0"))
+	float BeamPriorityBoost;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Replication, meta = (ClampMin = "1.0"))
+	float BeamPriorityDistance;
+
+	/* Extra priority right after a scale change */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Replication, meta = (ClampMin = "0.0"))
+	float ScalePriorityBoost;
+
+	/* Seconds for the beam and scale priority boosts to fade out */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Replication, meta = (ClampMin = "0.01"))
+	float PriorityFadeTime;
+
+	/* Seconds clients take to blend to a new replicated scale, about the beam commit interval */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Replication, meta = (ClampMin = "0.0"))
+	float ScaleInterpTime;
+
+protected:
+
+	// Movement replication does not carry the scale
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedScale)
+	FVector_NetQuantize100 ReplicatedScale;
+
+	// Client blend from the scale when the last one arrived
+	FVector InterpStartScale;
+	float InterpAlpha;
+
+	// Server activity, in world seconds
+	float LastBeamedTime;
+	float LastBeamDistance;
+	float LastScaleTime;
+	float LastWakeTime;
+	bool bDormancyManaged;
+	bool bDormant;
+
+
+	// Mass and uniform scale on begin play, Linear and Constant policies are relative to them
+	float BaseMass;
+	float BaseScale;
+};
@@ -3,3 +3,15 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "HAL/LowLevelMemStats.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogBeam, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("Beam"), STATGROUP_Beam, STATCAT_Advanced);
+
+// Low level memory tags, run with -llm and look at stat LLMFULL
+DECLARE_LLM_MEMORY_STAT_EXTERN(TEXT("Beam"), STAT_BeamLLM, STATGROUP_LLMFULL, DIMINUATOR_API);
+DECLARE_LLM_MEMORY_STAT_EXTERN(TEXT("BeamScaling"), STAT_BeamScalingLLM, STATGROUP_LLMFULL, DIMINUATOR_API);
+DECLARE_LLM_MEMORY_STAT_EXTERN(TEXT("Projectile"), STAT_ProjectileLLM, STATGROUP_LLMFULL, DIMINUATOR_API);
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "DiminuatorTypes.h"
 
 #include "DiminuatorCharacter.generated.h"
 
@@ -61,9 +62,24 @@ class ADiminuatorCharacter : public ACharacter
 public:
 	ADiminuatorCharacter();
 
+	/** Soft referenced assets the game mode preloads for this character */
+	void GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const;
+
+	/** Beam trigger pressed, the beam runs on the server and is drawn on every machine */
+	void StartBeam(BeamMode Mode);
+
+	/** Beam trigger released */
+	void StopBeam(BeamMode Mode);
+
+	/** Fires a projectile, spawned by the server. Used by the load test bots, there is no player input for it */
+	void Fire();
+
 protected:
 	virtual void BeginPlay();
 
+	/** Adds the beam bot on -BeamBot clients once the pawn is possessed */
+	virtual void PawnClientRestart() override;
+
 public:
 	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
@@ -73,17 +89,17 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
 	float BaseLookUpRate;
 
-	/** Projectile class to spawn */
+	/** Projectile class to spawn, loaded during the preload phase */
 	UPROPERTY(EditDefaultsOnly, Category=Projectile)
-	TSubclassOf<class ADiminuatorProjectile> ProjectileClass;
+	TSoftClassPtr<class ADiminuatorProjectile> ProjectileClass;
 
-	/** Sound to play each time we fire */
+	/** Sound to play each time we fire, loaded during the preload phase */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Gameplay)
-	USoundBase* FireSound;
+	TSoftObjectPtr<USoundBase> FireSound;
 
-	/** AnimMontage to play each time we fire */
+	/** AnimMontage to play each time we fire, loaded during the preload phase */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
-	UAnimMontage* FireAnimation;
+	TSoftObjectPtr<UAnimMontage> FireAnimation;
 
 	/** Whether to use motion controller location for aiming. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
@@ -128,6 +144,23 @@ protected:
 
 	void OnReset();
 
+	/* Rooms and levels belong to the server, clients ask it for the reset */
+	UFUNCTION(Server, Reliable)
+	void ServerReset();
+
+	void ResetRoom();
+
+	UFUNCTION(Server, Reliable)
+	void ServerStartBeam(TEnumAsByte<BeamMode> Mode);
+
+	UFUNCTION(Server, Reliable)
+	void ServerStopBeam(TEnumAsByte<BeamMode> Mode);
+
+	UFUNCTION(Server, Reliable)
+	void ServerFire();
+
+	void SpawnProjectile();
+
 protected:
 	// APawn interface
 	virtual void SetupPlayerInputComponent(UInputComponent* InputComponent) override;
@@ -140,5 +173,13 @@ public:
 	UCameraComponent* GetFirstPersonCameraComponent() const { return FirstPersonCameraComponent; }
 
 	USceneComponent* GetFP_MuzzleLocation() const { return FP_MuzzleLocation; }
+
+	USceneComponent* GetVR_MuzzleLocation() const { return VR_MuzzleLocation; }
+
+	/** Returns R_MotionController subobject, the VR beam is aimed from this hand **/
+	UMotionControllerComponent* GetR_MotionController() const { return R_MotionController; }
+
+	/** Returns BeamComponent subobject **/
+	UBeamComponent* GetBeamComponent() const { return BeamComponent; }
 };
 
@@ -6,6 +6,8 @@
 #include "GameFramework/GameModeBase.h"
 #include "DiminuatorGameMode.generated.h"
 
+class AStressScenarioLoader;
+
 UCLASS(minimalapi)
 class ADiminuatorGameMode : public AGameModeBase
 {
@@ -13,6 +15,30 @@ class ADiminuatorGameMode : public AGameModeBase
 
 public:
 	ADiminuatorGameMode();
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	virtual void StartPlay() override;
+
+	/** Players spawn once the pawn class is loaded */
+	virtual bool PlayerCanRestart_Implementation(APlayerController* Player) override;
+
+	/** Pawn class loaded asynchronously during the preload phase, replaces DefaultPawnClass unless a blueprint set it */
+	UPROPERTY(EditDefaultsOnly, Category = Classes)
+	TSoftClassPtr<APawn> DefaultPawnSoftClass;
+
+	/** Loader spawned when the game runs with -StressScenario=<file> and the level has none */
+	UPROPERTY(EditDefaultsOnly, Category = Stress)
+	TSubclassOf<AStressScenarioLoader> StressScenarioLoaderClass;
+
+protected:
+
+	void OnPawnClassLoaded();
+
+	/** True while DefaultPawnClass is unset or native */
+	bool IsNativePawnClass() const;
+
+	bool bPawnClassLoaded;
 };
 
 
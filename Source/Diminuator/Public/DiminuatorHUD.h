@@ -17,9 +17,13 @@ public:
 	/** Primary draw call for the HUD */
 	virtual void DrawHUD() override;
 
+	/** Assets the game mode preloads for this HUD */
+	void GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets) const;
+
 private:
-	/** Crosshair asset pointer */
-	class UTexture2D* CrosshairTex;
+	/** Crosshair asset, loaded during the preload phase */
+	UPROPERTY(EditDefaultsOnly, Category = HUD)
+	TSoftObjectPtr<class UTexture2D> CrosshairTex;
 
 };
 
@@ -3,6 +3,13 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+
+#include "DiminuatorTypes.generated.h"
+
+// Custom object channels, see DefaultEngine.ini
+#define ECC_Glass		ECC_GameTraceChannel2
+#define ECC_Scalable	ECC_GameTraceChannel3
 
 UENUM()
 enum BeamMode
@@ -12,3 +19,21 @@ enum BeamMode
 	GRAB			UMETA(DisplayName = "GRAB"),
 	OFF				UMETA(DisplayName = "OFF"),
 };
+
+/*
+* Beam aim sample: muzzle transform in world space and the time it was read.
+* Replicated from the player holding the beam, the sample time stays local.
+*/
+USTRUCT()
+struct FBeamAimPose
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector_NetQuantize10 Location = FVector::ZeroVector;
+
+	UPROPERTY()
+	FRotator Rotation = FRotator::ZeroRotator;
+
+	double SampleTime = 0.0;
+};
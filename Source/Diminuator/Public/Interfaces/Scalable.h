@@ -0,0 +1,68 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+
+#include "Scalable.generated.h"
+
+class UPrimitiveComponent;
+
+/*
+* How the mass of a scalable object follows its scale
+*/
+UENUM(BlueprintType)
+enum class EScalableMassPolicy : uint8
+{
+	Volume		UMETA(DisplayName = "Volume", ToolTip = "Physics default, mass grows with the cube of the scale"),
+	Linear		UMETA(DisplayName = "Linear", ToolTip = "Mass grows linearly with the scale, big objects stay pushable"),
+	Constant	UMETA(DisplayName = "Constant", ToolTip = "Mass never changes"),
+};
+
+/*
+* Shape probed around a scalable object before letting it grow
+*/
+UENUM(BlueprintType)
+enum class EScalableClearanceShape : uint8
+{
+	Box			UMETA(DisplayName = "Box", ToolTip = "4 probes per face from the box corners"),
+	Sphere		UMETA(DisplayName = "Sphere", ToolTip = "1 probe per face from the face centers, cheaper"),
+};
+
+UINTERFACE(MinimalAPI, BlueprintType)
+class UScalable : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/*
+* Object the beam can scale. Implemented by the actor or one of its components,
+* UScalableComponent is the ready made one. Objects without it fall back to the beam settings.
+*/
+class DIMINUATOR_API IScalable
+{
+	GENERATED_BODY()
+
+public:
+
+	/* Smallest uniform scale */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = Scalable)
+	float GetMinScale() const;
+
+	/* Biggest uniform scale */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = Scalable)
+	float GetMaxScale() const;
+
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = Scalable)
+	EScalableMassPolicy GetMassPolicy() const;
+
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = Scalable)
+	EScalableClearanceShape GetClearanceShape() const;
+
+	/* The physics body of Component just got NewScale */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = Scalable)
+	void OnScaleCommitted(UPrimitiveComponent* Component, FVector NewScale);
+
+	/* Scalable object of a component: its actor if it implements the interface, else the first component that does */
+	static UObject* Find(const UPrimitiveComponent* Component);
+};
@@ -0,0 +1,65 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/StreamableManager.h"
+
+#include "AssetPreloadSubsystem.generated.h"
+
+/*
+* Startup preload phase. Soft referenced assets are requested here instead of loaded
+* synchronously in constructors. Every machine preloads the character assets and the
+* ones that draw also the HUD, the server game mode adds its pawn class on top. Batches load asynchronously
+* by priority and report their timing, -StartupBenchmark logs time to first frame,
+* preload time and memory once everything is in and quits.
+*/
+UCLASS()
+class DIMINUATOR_API UAssetPreloadSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	/* Loads Assets asynchronously, OnLoaded runs on the game thread once all of them are in */
+	void RequestPreload(const FString& Name, const TArray<FSoftObjectPath>& Assets, TAsyncLoadPriority Priority, FStreamableDelegate OnLoaded = FStreamableDelegate());
+
+	bool IsPreloading() const { return PendingBatches > 0; }
+
+	static UAssetPreloadSubsystem* Get(const UObject* WorldContextObject);
+
+protected:
+
+	/* Local assets, the game mode only exists on the server */
+	void RequestLocalPreload();
+
+	void OnLocalPawnClassLoaded();
+
+	void OnBatchLoaded(FString Name, int32 NumAssets, double RequestTime, FStreamableDelegate OnLoaded);
+
+	void OnEndFrame();
+
+	void TryReportStartup();
+
+	FStreamableManager StreamableManager;
+
+	TSoftClassPtr<APawn> LocalPawnClass;
+
+	// Handles keep the preloaded assets alive for the whole game
+	TArray<TSharedPtr<FStreamableHandle>> Handles;
+
+	int32 PendingBatches;
+	double PreloadStartTime;
+	double PreloadEndTime;
+
+	// Seconds from process start to the end of the first frame
+	double FirstFrameTime;
+	FDelegateHandle EndFrameHandle;
+
+	bool bStartupBenchmark;
+	bool bStartupReported;
+};
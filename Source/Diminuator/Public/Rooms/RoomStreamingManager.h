@@ -0,0 +1,157 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+#include "RoomStreamingManager.generated.h"
+
+class UWorld;
+class ULevelStreamingDynamic;
+
+/*
+* Puzzle room sublevel (walls, exit door, spawners and cubes) and where it goes in the world
+*/
+USTRUCT(BlueprintType)
+struct FStreamedRoom
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Room)
+	TSoftObjectPtr<UWorld> Level;
+
+	/* Room placement in the persistent level */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Room)
+	FTransform Transform;
+
+	/* Player start when the room is reset, relative to the room */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Room)
+	FTransform Entry;
+};
+
+/*
+* Streams puzzle rooms in and out of the persistent level.
+* The rooms after the current one load asynchronously while the player is still solving it,
+* finished rooms are unloaded and resets reload only the current room.
+* The server decides the room and the resets, every machine streams the same room instances.
+* Each transition logs its worst game thread frame so hitches show up in benchmark runs.
+*/
+UCLASS()
+class DIMINUATOR_API ARoomStreamingManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	ARoomStreamingManager();
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/* First room streaming manager in the world */
+	static ARoomStreamingManager* Get(const UWorld* World);
+
+	/* Makes Index the current room, preloads the next ones and unloads finished ones */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = Rooms)
+	void EnterRoom(int32 Index);
+
+	/* To call from the room exit (e.g. the exit door blueprint) when the current room is solved */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = Rooms)
+	void AdvanceRoom();
+
+	/*
+	* Reloads the current room and moves the player to its entry, no level travel.
+	* The old instance stays until the new one is visible, players never stand in an empty room.
+	*/
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = Rooms)
+	void ResetCurrentRoom();
+
+	UFUNCTION(BlueprintPure, Category = Rooms)
+	int32 GetCurrentRoom() const { return CurrentRoom; }
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	UFUNCTION()
+	void OnRep_RoomState();
+
+	/* Follows the server: enters its room and reloads the current one when it was reset */
+	void ApplyRoomState();
+
+	/* Times the server reset the room, part of the instance name */
+	int32 GetRoomGeneration(int32 Index) const;
+
+	void ShowRoom(int32 Index);
+
+	void ReloadCurrentRoom();
+
+	void LoadRoom(int32 Index);
+
+	void UnloadRoom(int32 Index);
+
+	void UnloadLevel(ULevelStreamingDynamic* Level);
+
+	/* Swaps in the fresh instance once it is visible */
+	void UpdateReset();
+
+	void TeleportPlayersToEntry(int32 Index);
+
+	bool IsRoomLoading() const;
+
+	void BeginTransition(const FString& Name);
+
+	void EndTransition();
+
+public:
+
+	/* Rooms in play order */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Rooms)
+	TArray<FStreamedRoom> Rooms;
+
+	/* Rooms loaded ahead of the current one */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Rooms, meta = (ClampMin = "0"))
+	int32 PreloadAhead;
+
+	/* Finished rooms kept loaded behind the current one, so the door behind does not vanish */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Rooms, meta = (ClampMin = "0"))
+	int32 KeepBehind;
+
+	/* Game thread frame time above this during a transition is reported as a hitch */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Benchmark)
+	float HitchThresholdMs;
+
+	/* Seconds a transition is measured after all its loads finished */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Benchmark)
+	float TransitionSettleTime;
+
+protected:
+
+	// Room the server is in and how many times each room was reset
+	UPROPERTY(ReplicatedUsing = OnRep_RoomState)
+	int32 ServerRoom;
+	UPROPERTY(ReplicatedUsing = OnRep_RoomState)
+	TArray<int32> RoomGenerations;
+
+	// Streaming level per room, null when unloaded, and the generation it was loaded for
+	UPROPERTY(Transient)
+	TArray<ULevelStreamingDynamic*> RoomLevels;
+	TArray<int32> RoomLevelGenerations;
+
+	int32 CurrentRoom;
+
+	// Instance being replaced by a reset, kept until the new one is visible
+	UPROPERTY(Transient)
+	ULevelStreamingDynamic* ResetOldLevel;
+	int32 ResetRoom;
+
+	// Transition measurement
+	bool bInTransition;
+	FString TransitionName;
+	double TransitionStartTime;
+	float TransitionSettleTimer;
+	float WorstFrameMs;
+	int32 HitchFrames;
+	uint64 PeakUsedPhysical;
+};
@@ -0,0 +1,72 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "ServerLoadReport.generated.h"
+
+/*
+* Server load report for bot runs. Every few seconds logs a ServerLoad CSV line with
+* the connected players, game thread tick time, beam CPU time, net flush time, bandwidth
+* per player and how many scalable objects are awake on the network.
+* Created on dedicated servers and on any game run with -LoadReport.
+*/
+UCLASS()
+class DIMINUATOR_API UServerLoadReport : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/* Game thread cycles spent in beam code, added by FBeamCpuScope */
+	static uint64 BeamCycles;
+
+	/* Scalable objects with net dormancy managed by UScalableComponent, and the ones not dormant */
+	static int32 ScalableObjects;
+	static int32 AwakeScalableObjects;
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+	// End of FTickableGameObject interface
+
+protected:
+
+	void Report();
+
+	// Net driver flush (actor replication and sends) runs between these two
+	void OnPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnPostTickFlush();
+
+	// Current report window
+	float WindowTime = 0.0f;
+	int32 WindowFrames = 0;
+	double TickMsSum = 0.0;
+	float WorstTickMs = 0.0f;
+	uint64 WindowStartBeamCycles = 0;
+	uint64 WindowFlushCycles = 0;
+	int32 WorstAwakeScalableObjects = 0;
+
+	uint64 FlushStartCycles = 0;
+	FDelegateHandle PostActorTickHandle;
+	FDelegateHandle PostTickFlushHandle;
+};
+
+/*
+* Counts the game thread time of a scope as beam CPU time in the server load report
+*/
+struct FBeamCpuScope
+{
+	FBeamCpuScope() : StartCycles(FPlatformTime::Cycles64()) {}
+	~FBeamCpuScope() { UServerLoadReport::BeamCycles += FPlatformTime::Cycles64() - StartCycles; }
+
+	uint64 StartCycles;
+};
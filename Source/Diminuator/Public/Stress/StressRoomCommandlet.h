@@ -0,0 +1,39 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Stress/StressScenarioFormat.h"
+
+#include "StressRoomCommandlet.generated.h"
+
+/*
+* Generates stress scenario files: a grid of rooms with glass walls, a glass ceiling,
+* spawners and N cubes each.
+*
+* UE4Editor-Cmd Diminuator.uproject -run=StressRoom -Out=Stress.bin -Rooms=100 -Cubes=1000
+*	-Out			output file, relative paths go to Saved/StressScenarios
+*	-Rooms			number of rooms (default 1)
+*	-Cubes			cubes per room (default 100)
+*	-GlassWalls		glass walls per room, up to 4 (default 4)
+*	-Spawners		spawners per room (default 1)
+*	-RoomSize		room side in cm (default 2000)
+*	-Seed			random seed (default 0)
+*/
+UCLASS()
+class UStressRoomCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UStressRoomCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+
+	void GenerateRoom(uint32 RoomIndex, const FVector& Origin, float RoomSize, int32 NumCubes, int32 NumGlassWalls, int32 NumSpawners, FRandomStream& Random, TArray<FStressScenarioObject>& OutObjects) const;
+
+	static FStressScenarioObject MakeObject(EStressObjectType Type, uint32 RoomIndex, const FVector& Location, float Yaw, const FVector& Scale);
+};
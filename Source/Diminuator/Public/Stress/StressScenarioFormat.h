@@ -0,0 +1,76 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Stress scenario file layout, read in place from a memory mapped file:
+* FStressScenarioHeader followed by NumObjects FStressScenarioObject records.
+* Little endian, no padding between records.
+*/
+
+#define STRESS_SCENARIO_MAGIC	0x52545344	// "DSTR"
+#define STRESS_SCENARIO_VERSION	1
+
+enum class EStressObjectType : uint8
+{
+	Cube,
+	GlassWall,
+	GlassCeiling,
+	Spawner,
+
+	Count
+};
+
+struct FStressScenarioHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint32 NumObjects;
+	uint32 NumRooms;
+	uint32 Seed;
+	float RoomSize;
+	uint32 Reserved[2];
+};
+
+struct FStressScenarioObject
+{
+	float Location[3];
+	float Yaw;
+	float Scale[3];
+	uint8 Type;
+	uint8 Room[3];	// 24 bit room index, rooms are spawned in order
+};
+
+static_assert(sizeof(FStressScenarioHeader) == 32, "Stress scenario header layout changed, bump STRESS_SCENARIO_VERSION");
+static_assert(sizeof(FStressScenarioObject) == 32, "Stress scenario object layout changed, bump STRESS_SCENARIO_VERSION");
+
+/*
+* Non owning view over scenario data, validates the header and sizes
+*/
+struct FStressScenarioView
+{
+	const FStressScenarioHeader* Header = nullptr;
+	const FStressScenarioObject* Objects = nullptr;
+
+	bool Init(const uint8* Data, int64 Size)
+	{
+		if (Data == nullptr || Size < static_cast<int64>(sizeof(FStressScenarioHeader)))
+		{
+			return false;
+		}
+
+		const FStressScenarioHeader* header = reinterpret_cast<const FStressScenarioHeader*>(Data);
+		const int64 expectedSize = sizeof(FStressScenarioHeader) + static_cast<int64>(header->NumObjects) * sizeof(FStressScenarioObject);
+		if (header->Magic != STRESS_SCENARIO_MAGIC || header->Version != STRESS_SCENARIO_VERSION || Size < expectedSize)
+		{
+			return false;
+		}
+
+		Header = header;
+		Objects = reinterpret_cast<const FStressScenarioObject*>(Data + sizeof(FStressScenarioHeader));
+		return true;
+	}
+
+	int32 Num() const { return (Header != nullptr) ? static_cast<int32>(Header->NumObjects) : 0; }
+};
@@ -0,0 +1,82 @@
+// Tequila Works test
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Async/MappedFileHandle.h"
+#include "Stress/StressScenarioFormat.h"
+
+#include "StressScenarioLoader.generated.h"
+
+/*
+* Populates the level from a stress scenario file generated by the StressRoom commandlet.
+* The file is memory mapped and read in place, spawning is spread over frames
+* so big scenarios do not freeze the game thread. Only spawns on the authority,
+* clients get the objects through replication.
+*/
+UCLASS()
+class DIMINUATOR_API AStressScenarioLoader : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	AStressScenarioLoader();
+
+	virtual void Tick(float DeltaTime) override;
+
+	/* Maps the scenario file and starts spawning, false if the file is missing or invalid */
+	bool LoadScenario(const FString& FileName);
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/* Starts spawning once the object classes are in */
+	void OnClassesLoaded();
+
+	void SpawnObject(const FStressScenarioObject& Object);
+
+	void Unmap();
+
+public:
+
+	/* Scenario to load on begin play, relative paths are searched in Saved/StressScenarios */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Stress)
+	FString ScenarioFile;
+
+	/* Classes spawned for each object type, loaded asynchronously when a scenario loads */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Stress)
+	TSoftClassPtr<AActor> CubeClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Stress)
+	TSoftClassPtr<AActor> GlassWallClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Stress)
+	TSoftClassPtr<AActor> GlassCeilingClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Stress)
+	TSoftClassPtr<AActor> SpawnerClass;
+
+	/* Game thread time spent spawning each frame, in milliseconds */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Stress, meta = (ClampMin = "0.1"))
+	float SpawnBudgetMs;
+
+protected:
+
+	// Mapped scenario, released once everything is spawned
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	FStressScenarioView Scenario;
+
+	// Loaded object classes by EStressObjectType, null for the missing ones
+	UPROPERTY(Transient)
+	TArray<TSubclassOf<AActor>> ObjectClasses;
+
+	// Next object to spawn
+	int32 NextObject;
+	int32 NumSkipped;
+	double LoadStartTime;
+};
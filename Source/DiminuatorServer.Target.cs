@@ -0,0 +1,14 @@
+// Tequila Works test
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+public class DiminuatorServerTarget : TargetRules
+{
+	public DiminuatorServerTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Server;
+		DefaultBuildSettings = BuildSettingsVersion.V2;
+		ExtraModuleNames.Add("Diminuator");
+	}
+}
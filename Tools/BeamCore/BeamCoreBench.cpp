@@ -0,0 +1,205 @@
+// Tequila Works test
+//
+// Beam core microbenchmarks against a fake scene, no engine needed.
+// Prints one CSV line per kernel: BeamCoreBench,kernel,iterations,ns per call
+// and one per scale commit scenario: BeamCoreScaleCommits,scenario,frames,commits,frames per commit
+
+#include "BeamRules.h"
+#include "BeamClearance.h"
+#include "BeamCoreFakeScene.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace BeamCore;
+using namespace BeamCoreTools;
+
+namespace
+{
+	// Results go here so the optimizer keeps the work
+	volatile int64_t Sink = 0;
+
+	template<typename KernelType>
+	void RunBenchmark(const char* Name, int64_t Iterations, KernelType&& Kernel)
+	{
+		// Warm up caches and branch predictors
+		for (int64_t i = 0; i < Iterations / 10; ++i)
+		{
+			Kernel(i);
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		for (int64_t i = 0; i < Iterations; ++i)
+		{
+			Kernel(i);
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+		std::printf("BeamCoreBench,%s,%lld,%.2f\n", Name, static_cast<long long>(Iterations), ns / static_cast<double>(Iterations));
+	}
+
+	/*
+	* Collision rebuilds of an object scaled at 60 fps from one scale to the other. Without the
+	* preview every scaling frame rebuilds, so frames per commit is the rebuild reduction.
+	*/
+	void RunScaleCommits(const char* Name, const FBeamScaleCommitParams& Params, float ScaleSpeed, float HalfExtent, float FromScale, float ToScale)
+	{
+		const EBeamMode mode = (ToScale > FromScale) ? EBeamMode::Augmentator : EBeamMode::Diminuator;
+		const float frameTime = 1.0f / 60.0f;
+		float scale = FromScale;
+		float committedScale = FromScale;
+		float timeSinceCommit = 0.0f;
+		int32_t frames = 0;
+		int32_t commits = 0;
+		while ((mode == EBeamMode::Augmentator) ? scale < ToScale : scale > ToScale)
+		{
+			scale += GetBeamScaleRate(mode, ScaleSpeed) * frameTime;
+			timeSinceCommit += frameTime;
+			frames++;
+			if (ShouldCommitScale(Params, timeSinceCommit, (scale - committedScale) * HalfExtent))
+			{
+				committedScale = scale;
+				timeSinceCommit = 0.0f;
+				commits++;
+			}
+		}
+		// The beam leaving the object commits the rest
+		commits += (committedScale != scale) ? 1 : 0;
+		std::printf("BeamCoreScaleCommits,%s,%d,%d,%.1f\n", Name, frames, commits, static_cast<float>(frames) / static_cast<float>(commits));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const int64_t iterations = (argc > 1) ? std::atoll(argv[1]) : 1000000;
+	if (iterations <= 0)
+	{
+		std::fprintf(stderr, "Usage: BeamCoreBench [iterations]\n");
+		return 1;
+	}
+
+	// Same random sequences every run
+	std::mt19937 random(1234);
+	const int32_t numInputs = 4096;
+	const int32_t inputMask = numInputs - 1;
+
+	std::vector<EBeamMode> triggers(numInputs);
+	std::vector<float> sizes(numInputs);
+	std::vector<float> distances(numInputs);
+	std::uniform_int_distribution<int> triggerDistribution(0, 1);
+	std::uniform_real_distribution<float> sizeDistribution(0.1f, 3.0f);
+	std::uniform_real_distribution<float> distanceDistribution(0.0f, 1000.0f);
+	for (int32_t i = 0; i < numInputs; ++i)
+	{
+		triggers[i] = static_cast<EBeamMode>(triggerDistribution(random));
+		sizes[i] = sizeDistribution(random);
+		distances[i] = distanceDistribution(random);
+	}
+
+	// State machine fed with random trigger presses and releases
+	EBeamMode mode = EBeamMode::Off;
+	RunBenchmark("NextBeamMode", iterations, [&](int64_t i)
+	{
+		mode = NextBeamMode(mode, triggers[i & inputMask]);
+		Sink += static_cast<int64_t>(mode);
+	});
+
+	RunBenchmark("GetBeamScaleRate", iterations, [&](int64_t i)
+	{
+		Sink += static_cast<int64_t>(GetBeamScaleRate(static_cast<EBeamMode>(i & 3), 5.0f));
+	});
+
+	// Scaling rule with a cheap clearance answer, the rule itself is what is measured
+	const FBeamScaleLimits limits = { 0.3f, 2.5f, false };
+	RunBenchmark("CanScale", iterations, [&](int64_t i)
+	{
+		const float current = sizes[i & inputMask];
+		const float next = sizes[(i + 1) & inputMask];
+		Sink += CanScale(limits, current, next, [i]() { return (i & 7) == 0; }) ? 1 : 0;
+	});
+
+	// Object pulled into a wall most of the time, released and grabbed again over and over
+	const FBeamStuckParams stuckParams = { 50.0f, 1.0f, 0.25f };
+	const FBeamVector wallNormal(-1.0f, 0.0f, 0.0f);
+	FBeamStuckDetector stuckDetector;
+	RunBenchmark("StuckDetector", iterations, [&](int64_t i)
+	{
+		const FBeamVector trackingError(distances[i & inputMask], 10.0f, 0.0f);
+		Sink += static_cast<int64_t>(stuckDetector.Update(stuckParams, 1.0f / 60.0f, trackingError, wallNormal, (i & 3) != 0));
+	});
+
+	// A cube in a tight room: walls on two axes, open on the third
+	FFakeScene scene;
+	const float wallDistance = 110.0f;
+	const float wallHalfSize = 100.0f;
+	const FBeamVector walls[] =
+	{
+		FBeamVector(0.0f, 0.0f, wallDistance + wallHalfSize),
+		FBeamVector(0.0f, 0.0f, -wallDistance - wallHalfSize),
+		FBeamVector(0.0f, wallDistance + wallHalfSize, 0.0f),
+		FBeamVector(0.0f, -wallDistance - wallHalfSize, 0.0f),
+	};
+	for (const FBeamVector& wall : walls)
+	{
+		scene.AddBox(wall, wallHalfSize);
+	}
+	for (int32_t i = 0; i < 60; ++i)
+	{
+		// Clutter far away, every probe still tests against it
+		scene.AddBox(FBeamVector(2000.0f + i * 300.0f, 1000.0f, 0.0f), 50.0f);
+	}
+
+	FFakeProbeQueries queries(scene);
+	FBeamClearanceTarget target;
+	target.Center = FBeamVector(0.0f, 0.0f, 0.0f);
+	target.Rotation = FBeamQuat(0.0f, 0.0f, 0.3826834f, 0.9238795f);	// 45 degrees yaw
+	target.HalfLength = 100.0f;
+	target.MaxAge = 2;
+
+	target.Shape = EBeamClearanceShape::Box;
+	RunBenchmark("CheckClearanceBox", iterations / 10, [&](int64_t)
+	{
+		queries.NextFrame();
+		Sink += CheckClearance(queries, target) ? 1 : 0;
+	});
+
+	// Proximity shell side: faces next to the walls, then the probes of those faces only
+	const FBeamVector wallExtent(wallHalfSize, wallHalfSize, wallHalfSize);
+	uint8_t faceMask = 0;
+	RunBenchmark("GetOccupiedFaces", iterations, [&](int64_t i)
+	{
+		faceMask = GetOccupiedFaces(target, walls[i & 3], wallExtent);
+		Sink += faceMask;
+	});
+
+	faceMask = 0;
+	for (const FBeamVector& wall : walls)
+	{
+		faceMask |= GetOccupiedFaces(target, wall, wallExtent);
+	}
+	RunBenchmark("CheckClearanceBoxMasked", iterations / 10, [&](int64_t)
+	{
+		queries.NextFrame();
+		Sink += CheckClearance(queries, target, faceMask) ? 1 : 0;
+	});
+
+	target.Shape = EBeamClearanceShape::Sphere;
+	RunBenchmark("CheckClearanceSphere", iterations / 10, [&](int64_t)
+	{
+		queries.NextFrame();
+		Sink += CheckClearance(queries, target) ? 1 : 0;
+	});
+
+	// Beam component defaults on the 100 units cube
+	const FBeamScaleCommitParams commitParams = { 0.25f, 50.0f };
+	RunScaleCommits("CubeGrow", commitParams, 5.0f, 50.0f, 1.0f, 3.0f);
+	RunScaleCommits("CubeShrink", commitParams, 5.0f, 50.0f, 3.0f, 0.3f);
+	RunScaleCommits("CubeGrowSlow", commitParams, 0.5f, 50.0f, 1.0f, 3.0f);
+	RunScaleCommits("SmallCubeShrinkSlow", commitParams, 0.5f, 50.0f, 0.8f, 0.3f);
+
+	return 0;
+}
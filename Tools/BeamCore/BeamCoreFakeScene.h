@@ -0,0 +1,130 @@
+// Tequila Works test
+//
+// Fake scene for the standalone beam core tools, shared by the benchmarks and the tests
+
+#pragma once
+
+#include "BeamClearance.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace BeamCoreTools
+{
+	using BeamCore::FBeamVector;
+	using BeamCore::BeamClearanceMaxProbes;
+
+	/*
+	* Axis aligned boxes standing in for the level, segment tests only
+	*/
+	class FFakeScene
+	{
+	public:
+
+		struct FBox
+		{
+			FBeamVector Min;
+			FBeamVector Max;
+		};
+
+		void AddBox(const FBeamVector& Center, float HalfSize)
+		{
+			const FBeamVector extent(HalfSize, HalfSize, HalfSize);
+			Boxes.push_back({ Center - extent, Center + extent });
+		}
+
+		bool SegmentHits(const FBeamVector& Start, const FBeamVector& End) const
+		{
+			for (const FBox& box : Boxes)
+			{
+				if (SegmentHitsBox(Start, End, box))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+	private:
+
+		// Slab test
+		static bool SegmentHitsBox(const FBeamVector& Start, const FBeamVector& End, const FBox& Box)
+		{
+			const float start[3] = { Start.X, Start.Y, Start.Z };
+			const float delta[3] = { End.X - Start.X, End.Y - Start.Y, End.Z - Start.Z };
+			const float boxMin[3] = { Box.Min.X, Box.Min.Y, Box.Min.Z };
+			const float boxMax[3] = { Box.Max.X, Box.Max.Y, Box.Max.Z };
+
+			float tMin = 0.0f;
+			float tMax = 1.0f;
+			for (int32_t axis = 0; axis < 3; ++axis)
+			{
+				if (delta[axis] == 0.0f)
+				{
+					if (start[axis] < boxMin[axis] || start[axis] > boxMax[axis])
+					{
+						return false;
+					}
+					continue;
+				}
+
+				float t0 = (boxMin[axis] - start[axis]) / delta[axis];
+				float t1 = (boxMax[axis] - start[axis]) / delta[axis];
+				if (t0 > t1)
+				{
+					std::swap(t0, t1);
+				}
+				tMin = std::max(tMin, t0);
+				tMax = std::min(tMax, t1);
+				if (tMin > tMax)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		std::vector<FBox> Boxes;
+	};
+
+	/*
+	* Probe queries traced right away on submit, read back on the next frame like the scheduler does
+	*/
+	class FFakeProbeQueries : public BeamCore::IBeamProbeQueries
+	{
+	public:
+
+		explicit FFakeProbeQueries(const FFakeScene& InScene) : Scene(InScene) {}
+
+		virtual bool GetProbeResult(int32_t Index, int32_t& OutAge, bool& bOutHit) const override
+		{
+			const FResult& result = Results[Index];
+			OutAge = static_cast<int32_t>(Frame - result.Frame);
+			bOutHit = result.bHit;
+			return result.bValid;
+		}
+
+		virtual void SubmitProbe(int32_t Index, const FBeamVector& Start, const FBeamVector& End) override
+		{
+			FResult& result = Results[Index];
+			result.bHit = Scene.SegmentHits(Start, End);
+			result.bValid = true;
+			result.Frame = Frame;
+		}
+
+		void NextFrame() { Frame++; }
+
+	private:
+
+		struct FResult
+		{
+			bool bValid = false;
+			bool bHit = false;
+			uint64_t Frame = 0;
+		};
+
+		const FFakeScene& Scene;
+		FResult Results[BeamClearanceMaxProbes];
+		uint64_t Frame = 0;
+	};
+}
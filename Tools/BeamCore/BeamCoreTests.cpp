@@ -0,0 +1,297 @@
+// Tequila Works test
+//
+// Beam core unit tests against the fake scene, no engine needed. Run through ctest,
+// the exit code is the number of failed checks.
+
+#include "BeamRules.h"
+#include "BeamClearance.h"
+#include "BeamCoreFakeScene.h"
+
+#include <cmath>
+#include <cstdio>
+
+using namespace BeamCore;
+using namespace BeamCoreTools;
+
+namespace
+{
+	int32_t NumChecks = 0;
+	int32_t NumFailures = 0;
+
+	void Check(bool bCondition, const char* Expression, const char* File, int32_t Line)
+	{
+		NumChecks++;
+		if (!bCondition)
+		{
+			NumFailures++;
+			std::printf("%s:%d: check failed: %s\n", File, Line, Expression);
+		}
+	}
+
+	#define BEAM_CHECK(Condition) Check((Condition), #Condition, __FILE__, __LINE__)
+
+	// Face bits, in the BeamClearanceFaces order
+	const uint8_t UpFace = 1 << 0;
+	const uint8_t DownFace = 1 << 1;
+	const uint8_t LeftFace = 1 << 2;
+	const uint8_t RightFace = 1 << 3;
+
+	FBeamClearanceTarget MakeTarget(EBeamClearanceShape Shape)
+	{
+		FBeamClearanceTarget target;
+		target.Center = FBeamVector(0.0f, 0.0f, 0.0f);
+		target.Rotation = FBeamQuat();
+		target.HalfLength = 100.0f;
+		target.Shape = Shape;
+		target.MaxAge = 2;
+		return target;
+	}
+
+	/* Clearance the second frame, once the probes of the first one came back */
+	bool IsBlockedNextFrame(const FFakeScene& Scene, const FBeamClearanceTarget& Target, uint8_t FaceMask = BeamClearanceAllFaces)
+	{
+		FFakeProbeQueries queries(Scene);
+		CheckClearance(queries, Target, FaceMask);
+		queries.NextFrame();
+		return CheckClearance(queries, Target, FaceMask);
+	}
+
+	void TestNextBeamMode()
+	{
+		BEAM_CHECK(NextBeamMode(EBeamMode::Off, EBeamMode::Diminuator) == EBeamMode::Diminuator);
+		BEAM_CHECK(NextBeamMode(EBeamMode::Off, EBeamMode::Augmentator) == EBeamMode::Augmentator);
+
+		// The other trigger on top grabs, the same trigger again turns the beam off
+		BEAM_CHECK(NextBeamMode(EBeamMode::Diminuator, EBeamMode::Augmentator) == EBeamMode::Grab);
+		BEAM_CHECK(NextBeamMode(EBeamMode::Augmentator, EBeamMode::Diminuator) == EBeamMode::Grab);
+		BEAM_CHECK(NextBeamMode(EBeamMode::Diminuator, EBeamMode::Diminuator) == EBeamMode::Off);
+		BEAM_CHECK(NextBeamMode(EBeamMode::Augmentator, EBeamMode::Augmentator) == EBeamMode::Off);
+
+		// Releasing one trigger while grabbing leaves the other one on
+		BEAM_CHECK(NextBeamMode(EBeamMode::Grab, EBeamMode::Diminuator) == EBeamMode::Augmentator);
+		BEAM_CHECK(NextBeamMode(EBeamMode::Grab, EBeamMode::Augmentator) == EBeamMode::Diminuator);
+	}
+
+	void TestGetBeamScaleRate()
+	{
+		BEAM_CHECK(GetBeamScaleRate(EBeamMode::Diminuator, 5.0f) == -5.0f);
+		BEAM_CHECK(GetBeamScaleRate(EBeamMode::Augmentator, 5.0f) == 5.0f);
+		BEAM_CHECK(GetBeamScaleRate(EBeamMode::Grab, 5.0f) == 0.0f);
+		BEAM_CHECK(GetBeamScaleRate(EBeamMode::Off, 5.0f) == 0.0f);
+	}
+
+	void TestCanScale()
+	{
+		const FBeamScaleLimits limits = { 0.5f, 2.0f, false };
+		int32_t clearanceChecks = 0;
+		auto clear = [&clearanceChecks]() { clearanceChecks++; return false; };
+		auto blocked = [&clearanceChecks]() { clearanceChecks++; return true; };
+
+		BEAM_CHECK(CanScale(limits, 1.0f, 1.1f, clear));
+		BEAM_CHECK(!CanScale(limits, 1.0f, 1.1f, blocked));
+		BEAM_CHECK(clearanceChecks == 2);
+
+		// Limits are checked before the clearance, shrinking never asks for it
+		BEAM_CHECK(!CanScale(limits, 1.9f, 2.1f, clear));
+		BEAM_CHECK(CanScale(limits, 1.0f, 0.9f, blocked));
+		BEAM_CHECK(clearanceChecks == 2);
+
+		BEAM_CHECK(!CanScale(limits, 0.6f, 0.5f, clear));
+		const FBeamScaleLimits inclusiveLimits = { 0.5f, 2.0f, true };
+		BEAM_CHECK(CanScale(inclusiveLimits, 0.6f, 0.5f, clear));
+		BEAM_CHECK(!CanScale(inclusiveLimits, 0.6f, 0.4f, clear));
+
+		BEAM_CHECK(!CanScale(limits, 1.0f, 1.0f, clear));
+	}
+
+	void TestShouldCommitScale()
+	{
+		const FBeamScaleCommitParams params = { 0.25f, 50.0f };
+		BEAM_CHECK(!ShouldCommitScale(params, 0.1f, 10.0f));
+		BEAM_CHECK(ShouldCommitScale(params, 0.25f, 0.0f));
+		BEAM_CHECK(ShouldCommitScale(params, 0.1f, 50.0f));
+		BEAM_CHECK(ShouldCommitScale(params, 0.1f, -50.0f));
+
+		// A small cube shrinking slowly rebuilds on the interval, not every frame
+		const float frameTime = 1.0f / 60.0f;
+		const float halfExtent = 50.0f;
+		float scale = 0.8f;
+		float committedScale = scale;
+		float timeSinceCommit = 0.0f;
+		int32_t frames = 0;
+		int32_t commits = 0;
+		while (scale > 0.3f)
+		{
+			scale += GetBeamScaleRate(EBeamMode::Diminuator, 0.5f) * frameTime;
+			timeSinceCommit += frameTime;
+			frames++;
+			if (ShouldCommitScale(params, timeSinceCommit, (scale - committedScale) * halfExtent))
+			{
+				committedScale = scale;
+				timeSinceCommit = 0.0f;
+				commits++;
+			}
+		}
+		BEAM_CHECK(commits > 0 && commits * 10 <= frames);
+	}
+
+	void TestStuckDetector()
+	{
+		const FBeamStuckParams params = { 50.0f, 1.0f, 0.25f };
+		const float deltaTime = 0.25f;
+		const FBeamVector wallNormal(-1.0f, 0.0f, 0.0f);
+		const FBeamVector intoWall(100.0f, 0.0f, 0.0f);
+
+		// Pulled into a wall: stuck, then released after ReleaseTime
+		FBeamStuckDetector detector;
+		BEAM_CHECK(detector.Update(params, deltaTime, intoWall, wallNormal, true) == EBeamStuckAction::Stuck);
+		BEAM_CHECK(detector.Update(params, deltaTime, intoWall, wallNormal, true) == EBeamStuckAction::None);
+		BEAM_CHECK(detector.Update(params, deltaTime, intoWall, wallNormal, true) == EBeamStuckAction::None);
+		BEAM_CHECK(detector.Update(params, deltaTime, intoWall, wallNormal, true) == EBeamStuckAction::Release);
+		BEAM_CHECK(!detector.bStuck && detector.StuckTime == 0.0f);
+
+		// Following again before the release
+		BEAM_CHECK(detector.Update(params, deltaTime, intoWall, wallNormal, true) == EBeamStuckAction::Stuck);
+		BEAM_CHECK(detector.Update(params, deltaTime, FBeamVector(10.0f, 0.0f, 0.0f), wallNormal, true) == EBeamStuckAction::Unstuck);
+
+		// Fast swing without contacts, and a contact that does not oppose the pull, never get stuck
+		detector.Reset();
+		BEAM_CHECK(detector.Update(params, deltaTime, intoWall, wallNormal, false) == EBeamStuckAction::None);
+		const FBeamVector floorNormal(0.0f, 0.0f, 1.0f);
+		for (int32_t i = 0; i < 10; ++i)
+		{
+			BEAM_CHECK(detector.Update(params, deltaTime, intoWall, floorNormal, true) == EBeamStuckAction::None);
+		}
+	}
+
+	void TestRecentContacts()
+	{
+		const FBeamVector floorNormal(0.0f, 0.0f, 1.0f);
+		const FBeamVector wallNormal(-1.0f, 0.0f, 0.0f);
+		const FBeamVector intoWall(100.0f, 0.0f, 0.0f);
+		const float tolerance = 0.2f;
+
+		// Floor and wall on the same step, in either order the wall is the one against the pull
+		FBeamRecentContacts contacts;
+		FBeamVector normal;
+		contacts.Add(floorNormal, 1.0f);
+		contacts.Add(wallNormal, 1.0f);
+		BEAM_CHECK(contacts.GetMostOpposing(intoWall, 1.0f, tolerance, normal) && normal.X == -1.0f);
+		contacts.Reset();
+		contacts.Add(wallNormal, 1.0f);
+		contacts.Add(floorNormal, 1.0f);
+		BEAM_CHECK(contacts.GetMostOpposing(intoWall, 1.0f, tolerance, normal) && normal.X == -1.0f);
+
+		// Floor hits every step share one slot and do not push the wall out
+		for (int32_t i = 0; i < 10; ++i)
+		{
+			contacts.Add(FBeamVector(0.0f, 0.01f * i, 1.0f), 1.0f + i * 0.01f);
+		}
+		BEAM_CHECK(contacts.Num == 2);
+
+		// Contacts older than the tolerance are gone
+		BEAM_CHECK(contacts.GetMostOpposing(intoWall, 1.15f, tolerance, normal) && normal.X == -1.0f);
+		BEAM_CHECK(contacts.GetMostOpposing(intoWall, 1.25f, tolerance, normal) && normal.Z > 0.9f);
+		BEAM_CHECK(!contacts.GetMostOpposing(intoWall, 2.0f, tolerance, normal));
+
+		// Dragged along the floor into a wall, callbacks in a different order every step: released
+		const FBeamStuckParams params = { 50.0f, 1.0f, 0.25f };
+		const float deltaTime = 1.0f / 60.0f;
+		FBeamStuckDetector detector;
+		contacts.Reset();
+		bool bReleased = false;
+		for (int32_t step = 0; step < 90 && !bReleased; ++step)
+		{
+			const float now = step * deltaTime;
+			contacts.Add((step & 1) ? floorNormal : wallNormal, now);
+			contacts.Add((step & 1) ? wallNormal : floorNormal, now);
+			const bool bRecentContact = contacts.GetMostOpposing(intoWall, now, tolerance, normal);
+			bReleased = detector.Update(params, deltaTime, intoWall, normal, bRecentContact) == EBeamStuckAction::Release;
+		}
+		BEAM_CHECK(bReleased);
+	}
+
+	void TestCheckClearance()
+	{
+		const float wallHalfSize = 100.0f;
+		const float wallDistance = 110.0f;
+		const FBeamVector above(0.0f, 0.0f, wallDistance + wallHalfSize);
+		const FBeamVector below(0.0f, 0.0f, -wallDistance - wallHalfSize);
+
+		FFakeScene open;
+		FFakeScene floor;
+		floor.AddBox(below, wallHalfSize);
+		FFakeScene squeezed;
+		squeezed.AddBox(above, wallHalfSize);
+		squeezed.AddBox(below, wallHalfSize);
+
+		const EBeamClearanceShape shapes[] = { EBeamClearanceShape::Box, EBeamClearanceShape::Sphere };
+		for (EBeamClearanceShape shape : shapes)
+		{
+			// Wall distance is within reach of both probe sets
+			FBeamClearanceTarget target = MakeTarget(shape);
+			target.HalfLength = (shape == EBeamClearanceShape::Box) ? 100.0f : 55.0f;
+
+			// Nothing came back yet, blocked to be safe
+			FFakeProbeQueries queries(open);
+			BEAM_CHECK(CheckClearance(queries, target));
+
+			// Only both faces of a pair block
+			BEAM_CHECK(!IsBlockedNextFrame(open, target));
+			BEAM_CHECK(!IsBlockedNextFrame(floor, target));
+			BEAM_CHECK(IsBlockedNextFrame(squeezed, target));
+
+			// Faces out of the mask are clear
+			BEAM_CHECK(!IsBlockedNextFrame(squeezed, target, static_cast<uint8_t>(BeamClearanceAllFaces & ~UpFace)));
+
+			// Results older than MaxAge are blocked
+			CheckClearance(queries, target);
+			for (int32_t i = 0; i <= target.MaxAge + 1; ++i)
+			{
+				queries.NextFrame();
+			}
+			BEAM_CHECK(CheckClearance(queries, target));
+		}
+	}
+
+	void TestGetOccupiedFaces()
+	{
+		BEAM_CHECK(std::fabs(GetClearanceReach(EBeamClearanceShape::Box) - 1.25f) < 1e-4f);
+		BEAM_CHECK(std::fabs(GetClearanceReach(EBeamClearanceShape::Sphere) - 2.05f) < 1e-4f);
+
+		const FBeamClearanceTarget target = MakeTarget(EBeamClearanceShape::Box);
+		const FBeamVector wallExtent(100.0f, 100.0f, 100.0f);
+
+		// Ceiling within reach above, away from the sides
+		BEAM_CHECK(GetOccupiedFaces(target, FBeamVector(0.0f, 0.0f, 210.0f), FBeamVector(50.0f, 50.0f, 100.0f)) == UpFace);
+		BEAM_CHECK(GetOccupiedFaces(target, FBeamVector(0.0f, 0.0f, -210.0f), FBeamVector(50.0f, 50.0f, 100.0f)) == DownFace);
+
+		// Out of reach
+		BEAM_CHECK(GetOccupiedFaces(target, FBeamVector(0.0f, 0.0f, 240.0f), wallExtent) == 0);
+
+		// A floor touching the bottom face also touches the probes of the side faces
+		const uint8_t floorFaces = GetOccupiedFaces(target, FBeamVector(0.0f, 0.0f, -1100.0f), FBeamVector(1000.0f, 1000.0f, 1000.0f));
+		BEAM_CHECK((floorFaces & DownFace) != 0 && (floorFaces & UpFace) == 0);
+
+		// Rotated object: the body is bounded again in its axes, never fewer faces than the real ones
+		FBeamClearanceTarget rotated = target;
+		rotated.Rotation = FBeamQuat(0.0f, 0.0f, 0.3826834f, 0.9238795f);	// 45 degrees yaw
+		const uint8_t rotatedFaces = GetOccupiedFaces(rotated, FBeamVector(0.0f, 200.0f, 0.0f), FBeamVector(50.0f, 50.0f, 50.0f));
+		BEAM_CHECK((rotatedFaces & (LeftFace | RightFace)) != 0 && (rotatedFaces & (UpFace | DownFace)) == 0);
+	}
+}
+
+int main()
+{
+	TestNextBeamMode();
+	TestGetBeamScaleRate();
+	TestCanScale();
+	TestShouldCommitScale();
+	TestStuckDetector();
+	TestRecentContacts();
+	TestCheckClearance();
+	TestGetOccupiedFaces();
+
+	std::printf("BeamCoreTests: %d checks, %d failed\n", NumChecks, NumFailures);
+	return NumFailures;
+}